@@ -0,0 +1,146 @@
+#include "BlendMask.h"
+#include <iostream>
+#include <vector>
+#include "GlShader.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[BlendMask] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+// First frame of an image file as RGB24, top row first
+bool decodeImage(const std::string& path, std::vector<uint8_t>& rgb, int& width, int& height) {
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) return false;
+    int streamIndex = -1;
+    if (avformat_find_stream_info(formatContext, nullptr) >= 0) {
+        streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    }
+    if (streamIndex < 0) {
+        avformat_close_input(&formatContext);
+        return false;
+    }
+
+    AVStream* stream = formatContext->streams[streamIndex];
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext* codecContext = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!codecContext || avcodec_parameters_to_context(codecContext, stream->codecpar) < 0 ||
+        avcodec_open2(codecContext, codec, nullptr) < 0) {
+        avcodec_free_context(&codecContext);
+        avformat_close_input(&formatContext);
+        return false;
+    }
+
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    bool decoded = false;
+    while (!decoded && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex && avcodec_send_packet(codecContext, packet) >= 0) {
+            decoded = avcodec_receive_frame(codecContext, frame) >= 0;
+        }
+        av_packet_unref(packet);
+    }
+    if (!decoded && avcodec_send_packet(codecContext, nullptr) >= 0) {
+        decoded = avcodec_receive_frame(codecContext, frame) >= 0;
+    }
+
+    if (decoded) {
+        width = frame->width;
+        height = frame->height;
+        SwsContext* swsContext = sws_getContext(width, height, (AVPixelFormat)frame->format,
+                                                width, height, AV_PIX_FMT_RGB24,
+                                                SWS_POINT, nullptr, nullptr, nullptr);
+        if (swsContext) {
+            rgb.resize((size_t)width * height * 3);
+            uint8_t* dest[1] = { rgb.data() };
+            int destLinesize[1] = { width * 3 };
+            sws_scale(swsContext, frame->data, frame->linesize, 0, height, dest, destLinesize);
+            sws_freeContext(swsContext);
+        } else {
+            decoded = false;
+        }
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+    return decoded;
+}
+}
+
+BlendMask::~BlendMask() {
+    if (texture) {
+        GlShader::setBlendMask(0);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+bool BlendMask::init() {
+    if (!GlShader::load()) {
+        DEBUG_PRINT("No GLSL on this context - blend masks unavailable");
+        return false;
+    }
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+bool BlendMask::load(const std::string& maskPath) {
+    if (!texture) return false;
+
+    std::vector<uint8_t> rgb;
+    int width = 0, height = 0;
+    if (!decodeImage(maskPath, rgb, width, height)) {
+        DEBUG_PRINT("Can't load " << maskPath);
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    loaded = true;
+    path = maskPath;
+    std::error_code ignored;
+    loadedWriteTime = std::filesystem::last_write_time(path, ignored);
+    publish();
+    DEBUG_PRINT("Loaded " << path << " (" << width << "x" << height << ")");
+    return true;
+}
+
+void BlendMask::unload() {
+    if (!loaded) return;
+    loaded = false;
+    path.clear();
+    publish();
+    DEBUG_PRINT("Blend mask off");
+}
+
+void BlendMask::reloadIfChanged() {
+    if (path.empty()) return;
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (!error && writeTime != loadedWriteTime) {
+        // A failed decode (file still being written) retries at the next change
+        loadedWriteTime = writeTime;
+        load(path);
+    }
+}
+
+void BlendMask::publish() const {
+    GlShader::setBlendMask(loaded ? texture : 0);
+}
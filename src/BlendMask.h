@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <GL/gl.h>
+
+// Edge-blend / mask image for projector overlaps: any image FFmpeg reads
+// (PNG, TIFF, ...), stretched over the whole output and multiplied in by
+// GlShader's outputColor() - white passes, black masks, ramps feather the
+// overlap. Sampled in output space, so it stays put under a warp mesh.
+class BlendMask {
+public:
+    BlendMask() = default;
+    ~BlendMask();
+
+    // Needs the renderer's context current. False (logged) without GLSL.
+    bool init();
+
+    // Decode and upload; on failure the current mask (if any) stays
+    bool load(const std::string& path);
+    void unload();
+
+    // Re-load the current file if it was rewritten since it was loaded
+    void reloadIfChanged();
+
+    // Make this the mask outputColor() applies - load() and unload() do; with
+    // several outputs, each publishes its own before drawing
+    void publish() const;
+
+    bool isLoaded() const { return loaded; }
+    const std::string& getPath() const { return path; }
+
+private:
+    GLuint texture = 0;
+    bool loaded = false;
+
+    std::string path;
+    std::filesystem::file_time_type loadedWriteTime;
+};
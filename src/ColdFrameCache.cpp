@@ -0,0 +1,414 @@
+#include "ColdFrameCache.h"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[ColdFrameCache] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+
+enum BlobCodec : uint8_t {
+    CODEC_RLE = 1,
+    CODEC_LZ4 = 2
+};
+
+struct BlobHeader {
+    int32_t width;
+    int32_t height;
+    uint32_t rawSize;  // Size of the delta-coded YUV420 planes
+    uint8_t codec;
+};
+
+// One scaler per worker thread and direction, freed when the thread exits
+struct ThreadScalers {
+    SwsContext* toYuv = nullptr;
+    SwsContext* toRgb = nullptr;
+    ~ThreadScalers() {
+        if (toYuv) sws_freeContext(toYuv);
+        if (toRgb) sws_freeContext(toRgb);
+    }
+};
+thread_local ThreadScalers scalers;
+
+struct PlaneLayout {
+    int width[3];
+    int height[3];
+    size_t offset[3];
+    size_t totalSize;
+};
+
+PlaneLayout yuv420Layout(int width, int height) {
+    PlaneLayout layout;
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    layout.width[0] = width;
+    layout.height[0] = height;
+    layout.width[1] = layout.width[2] = chromaWidth;
+    layout.height[1] = layout.height[2] = chromaHeight;
+    layout.offset[0] = 0;
+    layout.offset[1] = (size_t)width * height;
+    layout.offset[2] = layout.offset[1] + (size_t)chromaWidth * chromaHeight;
+    layout.totalSize = layout.offset[2] + (size_t)chromaWidth * chromaHeight;
+    return layout;
+}
+
+// Left-neighbour prediction per row: flat areas become runs of zeros
+void deltaEncode(uint8_t* plane, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = plane + (size_t)y * width;
+        for (int x = width - 1; x > 0; x--) {
+            row[x] = (uint8_t)(row[x] - row[x - 1]);
+        }
+    }
+}
+
+void deltaDecode(uint8_t* plane, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = plane + (size_t)y * width;
+        for (int x = 1; x < width; x++) {
+            row[x] = (uint8_t)(row[x] + row[x - 1]);
+        }
+    }
+}
+
+// PackBits-style RLE: control < 0x80 = (n+1) literals, >= 0x80 = run of (n&0x7f)+3
+void rleEncode(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && src[i + run] == src[i] && run < 130) run++;
+
+        if (run >= 3) {
+            out.push_back((uint8_t)(0x80 | (run - 3)));
+            out.push_back(src[i]);
+            i += run;
+            continue;
+        }
+
+        size_t start = i;
+        size_t length = 0;
+        while (i < size && length < 128) {
+            if (i + 2 < size && src[i] == src[i + 1] && src[i] == src[i + 2]) break;
+            i++;
+            length++;
+        }
+        out.push_back((uint8_t)(length - 1));
+        out.insert(out.end(), src + start, src + start + length);
+    }
+}
+
+bool rleDecode(const uint8_t* src, size_t size, uint8_t* dest, size_t destSize) {
+    size_t in = 0;
+    size_t out = 0;
+    while (in < size) {
+        uint8_t control = src[in++];
+        if (control & 0x80) {
+            size_t run = (control & 0x7f) + 3;
+            if (in >= size || out + run > destSize) return false;
+            std::memset(dest + out, src[in++], run);
+            out += run;
+        } else {
+            size_t length = (size_t)control + 1;
+            if (in + length > size || out + length > destSize) return false;
+            std::memcpy(dest + out, src + in, length);
+            in += length;
+            out += length;
+        }
+    }
+    return out == destSize;
+}
+
+} // namespace
+
+ColdFrameCache::ColdFrameCache(size_t budgetBytes, PromoteCallback onPromoted)
+    : budgetBytes(budgetBytes), onPromoted(std::move(onPromoted)) {
+#ifdef HAVE_LZ4
+    DEBUG_PRINT("Cold tier: " << budgetBytes / (1024 * 1024) << " MB budget (YUV420 + LZ4)");
+#else
+    DEBUG_PRINT("Cold tier: " << budgetBytes / (1024 * 1024) << " MB budget (YUV420 + RLE)");
+#endif
+    for (unsigned i = 0; i < WORKER_COUNT; i++) {
+        workers.emplace_back(&ColdFrameCache::workerTask, this);
+    }
+}
+
+ColdFrameCache::~ColdFrameCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shouldStop = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void ColdFrameCache::submit(int frameIndex, std::shared_ptr<const VideoFrame> frame) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(frameIndex);
+        if (it != entries.end()) {
+            if (it->second.bufferId == frame->bufferId) {
+                // Still compressed from an earlier eviction - just refresh LRU
+                lruOrder.splice(lruOrder.end(), lruOrder, it->second.lruPosition);
+                return;
+            }
+            removeEntry(it);  // Different content at this index now
+        }
+        if (blobs.find(frame->bufferId) != blobs.end()) {
+            // Identical content already compressed under another index
+            addEntry(frameIndex, frame->bufferId);
+            return;
+        }
+        if (compressQueue.size() >= MAX_PENDING_COMPRESS) {
+            return;  // Workers saturated - drop, the decoder can rebuild it
+        }
+        compressQueue.push_back(PendingFrame{frameIndex, std::move(frame)});
+    }
+    workAvailable.notify_one();
+}
+
+void ColdFrameCache::requestPromote(int frameIndex) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (entries.find(frameIndex) == entries.end()) return;
+        if (!promotePending.insert(frameIndex).second) return;  // Already queued
+        promoteQueue.push_back(frameIndex);
+    }
+    workAvailable.notify_one();
+}
+
+void ColdFrameCache::erase(int frameIndex) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(frameIndex);
+    if (it != entries.end()) {
+        removeEntry(it);
+    }
+    compressQueue.erase(std::remove_if(compressQueue.begin(), compressQueue.end(),
+                                       [frameIndex](const PendingFrame& pending) {
+                                           return pending.frameIndex == frameIndex;
+                                       }),
+                        compressQueue.end());
+    if (promotePending.erase(frameIndex)) {
+        promoteQueue.erase(std::remove(promoteQueue.begin(), promoteQueue.end(), frameIndex), promoteQueue.end());
+    }
+}
+
+bool ColdFrameCache::contains(int frameIndex) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.find(frameIndex) != entries.end();
+}
+
+size_t ColdFrameCache::getFrameCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t ColdFrameCache::getUsedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return usedBytes;
+}
+
+size_t ColdFrameCache::getBudgetBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budgetBytes;
+}
+
+void ColdFrameCache::setBudgetBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgetBytes = bytes;
+    evictToBudget();
+}
+
+void ColdFrameCache::addEntry(int frameIndex, uint64_t bufferId) {
+    lruOrder.push_back(frameIndex);
+    entries[frameIndex] = Entry{bufferId, std::prev(lruOrder.end())};
+    blobs[bufferId].refs++;
+}
+
+void ColdFrameCache::removeEntry(std::unordered_map<int, Entry>::iterator it) {
+    auto blobIt = blobs.find(it->second.bufferId);
+    if (blobIt != blobs.end() && --blobIt->second.refs <= 0) {
+        usedBytes -= blobIt->second.data.size();
+        blobs.erase(blobIt);
+    }
+    lruOrder.erase(it->second.lruPosition);
+    entries.erase(it);
+}
+
+void ColdFrameCache::evictToBudget() {
+    while (usedBytes > budgetBytes && !lruOrder.empty()) {
+        auto it = entries.find(lruOrder.front());
+        if (it == entries.end()) {
+            lruOrder.pop_front();
+            continue;
+        }
+        removeEntry(it);
+    }
+}
+
+void ColdFrameCache::workerTask() {
+    while (true) {
+        int promoteIndex = -1;
+        std::vector<uint8_t> promoteBlob;
+        PendingFrame pending{-1, nullptr};
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this] {
+                return shouldStop || !promoteQueue.empty() || !compressQueue.empty();
+            });
+            if (shouldStop) break;
+
+            // Promotions first - somebody is waiting on those
+            if (!promoteQueue.empty()) {
+                promoteIndex = promoteQueue.front();
+                promoteQueue.pop_front();
+                promotePending.erase(promoteIndex);
+
+                auto it = entries.find(promoteIndex);
+                if (it == entries.end()) continue;  // Evicted meanwhile
+                lruOrder.splice(lruOrder.end(), lruOrder, it->second.lruPosition);
+                promoteBlob = blobs[it->second.bufferId].data;
+            } else {
+                pending = std::move(compressQueue.front());
+                compressQueue.pop_front();
+            }
+        }
+
+        if (promoteIndex >= 0) {
+            VideoFrame frame;
+            if (decompress(promoteBlob, frame)) {
+                onPromoted(promoteIndex, std::move(frame));
+            }
+            continue;
+        }
+
+        std::vector<uint8_t> blob = compress(*pending.frame);
+        if (blob.empty()) continue;
+
+        uint64_t bufferId = pending.frame->bufferId;
+        pending.frame.reset();  // Release the hot buffer before taking the lock
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto existing = entries.find(pending.frameIndex);
+        if (existing != entries.end()) {
+            if (existing->second.bufferId == bufferId) continue;
+            removeEntry(existing);  // Different content at this index now
+        }
+
+        auto blobIt = blobs.find(bufferId);
+        if (blobIt == blobs.end()) {
+            usedBytes += blob.size();
+            blobs[bufferId].data = std::move(blob);
+        }
+        addEntry(pending.frameIndex, bufferId);
+        evictToBudget();
+    }
+}
+
+std::vector<uint8_t> ColdFrameCache::compress(const VideoFrame& frame) {
+    if (frame.data.empty() || frame.width <= 0 || frame.height <= 0) return {};
+    // 8-bit 4:2:0 would throw away exactly what high-bit-depth frames are kept for
+    if (frame.format != VideoFrame::RGB24) return {};
+
+    PlaneLayout layout = yuv420Layout(frame.width, frame.height);
+
+    scalers.toYuv = sws_getCachedContext(scalers.toYuv,
+        frame.width, frame.height, AV_PIX_FMT_RGB24,
+        frame.width, frame.height, AV_PIX_FMT_YUV420P,
+        SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!scalers.toYuv) return {};
+
+    std::vector<uint8_t> yuv(layout.totalSize);
+    const uint8_t* src[1] = { frame.data.data() };
+    int srcLinesize[1] = { frame.linesize };
+    uint8_t* dest[3] = { yuv.data() + layout.offset[0], yuv.data() + layout.offset[1], yuv.data() + layout.offset[2] };
+    int destLinesize[3] = { layout.width[0], layout.width[1], layout.width[2] };
+
+    sws_scale(scalers.toYuv, src, srcLinesize, 0, frame.height, dest, destLinesize);
+
+    for (int plane = 0; plane < 3; plane++) {
+        deltaEncode(dest[plane], layout.width[plane], layout.height[plane]);
+    }
+
+    BlobHeader header{frame.width, frame.height, (uint32_t)layout.totalSize, 0};
+    std::vector<uint8_t> blob(sizeof(BlobHeader));
+
+#ifdef HAVE_LZ4
+    header.codec = CODEC_LZ4;
+    blob.resize(sizeof(BlobHeader) + LZ4_compressBound((int)yuv.size()));
+    int compressedSize = LZ4_compress_default(
+        reinterpret_cast<const char*>(yuv.data()),
+        reinterpret_cast<char*>(blob.data() + sizeof(BlobHeader)),
+        (int)yuv.size(), (int)(blob.size() - sizeof(BlobHeader)));
+    if (compressedSize <= 0) return {};
+    blob.resize(sizeof(BlobHeader) + compressedSize);
+#else
+    header.codec = CODEC_RLE;
+    blob.reserve(sizeof(BlobHeader) + yuv.size() / 2);
+    rleEncode(yuv.data(), yuv.size(), blob);
+#endif
+
+    std::memcpy(blob.data(), &header, sizeof(BlobHeader));
+    blob.shrink_to_fit();
+    return blob;
+}
+
+bool ColdFrameCache::decompress(const std::vector<uint8_t>& blob, VideoFrame& frame) {
+    if (blob.size() < sizeof(BlobHeader)) return false;
+
+    BlobHeader header;
+    std::memcpy(&header, blob.data(), sizeof(BlobHeader));
+
+    PlaneLayout layout = yuv420Layout(header.width, header.height);
+    if (layout.totalSize != header.rawSize) return false;
+
+    std::vector<uint8_t> yuv(layout.totalSize);
+    const uint8_t* payload = blob.data() + sizeof(BlobHeader);
+    size_t payloadSize = blob.size() - sizeof(BlobHeader);
+
+    if (header.codec == CODEC_RLE) {
+        if (!rleDecode(payload, payloadSize, yuv.data(), yuv.size())) return false;
+    }
+#ifdef HAVE_LZ4
+    else if (header.codec == CODEC_LZ4) {
+        int decoded = LZ4_decompress_safe(reinterpret_cast<const char*>(payload),
+                                          reinterpret_cast<char*>(yuv.data()),
+                                          (int)payloadSize, (int)yuv.size());
+        if (decoded != (int)yuv.size()) return false;
+    }
+#endif
+    else {
+        return false;
+    }
+
+    uint8_t* planes[3] = { yuv.data() + layout.offset[0], yuv.data() + layout.offset[1], yuv.data() + layout.offset[2] };
+    int planeLinesize[3] = { layout.width[0], layout.width[1], layout.width[2] };
+    for (int plane = 0; plane < 3; plane++) {
+        deltaDecode(planes[plane], layout.width[plane], layout.height[plane]);
+    }
+
+    scalers.toRgb = sws_getCachedContext(scalers.toRgb,
+        header.width, header.height, AV_PIX_FMT_YUV420P,
+        header.width, header.height, AV_PIX_FMT_RGB24,
+        SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!scalers.toRgb) return false;
+
+    frame.width = header.width;
+    frame.height = header.height;
+    frame.linesize = header.width * 3;
+    frame.data.resize((size_t)frame.linesize * frame.height);
+
+    uint8_t* dest[1] = { frame.data.data() };
+    int destLinesize[1] = { frame.linesize };
+    sws_scale(scalers.toRgb, planes, planeLinesize, 0, header.height, dest, destLinesize);
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+#include "VideoFrame.h"
+
+// Second cache tier behind VideoPlayer's hot (decoded RGB24) cache.
+// Frames evicted from the hot tier are compressed on worker threads
+// (RGB24 -> YUV420 -> per-row delta -> LZ4, or a zero-run RLE when LZ4 is
+// not available) and decompressed again on request. Restoring a frame
+// costs a sws_scale pass instead of a seek plus a GOP decode. Frames that
+// share a hot buffer (see VideoFrame::bufferId) also share one blob.
+// High-bit-depth (YUV16) frames are not kept here.
+class ColdFrameCache {
+public:
+    // Called on a worker thread with a freshly decompressed frame
+    using PromoteCallback = std::function<void(int frameIndex, VideoFrame&& frame)>;
+
+    ColdFrameCache(size_t budgetBytes, PromoteCallback onPromoted);
+    ~ColdFrameCache();
+
+    // Queue a frame evicted from the hot tier for compression (non-blocking)
+    void submit(int frameIndex, std::shared_ptr<const VideoFrame> frame);
+
+    // Queue a decompression; result is delivered through the promote callback
+    void requestPromote(int frameIndex);
+
+    bool contains(int frameIndex) const;
+
+    // Forget the frame at frameIndex (its content changed - raw input), along
+    // with any queued compression or promotion of it
+    void erase(int frameIndex);
+
+    size_t getFrameCount() const;
+    size_t getUsedBytes() const;
+    size_t getBudgetBytes() const;
+
+    // Shrinking evicts least recently used blobs immediately
+    void setBudgetBytes(size_t bytes);
+
+private:
+    struct Entry {
+        uint64_t bufferId;
+        std::list<int>::iterator lruPosition;
+    };
+
+    struct Blob {
+        std::vector<uint8_t> data;
+        int refs = 0;  // Number of entries (frame indices) using this blob
+    };
+
+    struct PendingFrame {
+        int frameIndex;
+        std::shared_ptr<const VideoFrame> frame;
+    };
+
+    // Compressed frames waiting for a worker; beyond this evicted frames are dropped
+    static constexpr size_t MAX_PENDING_COMPRESS = 32;
+    static constexpr unsigned WORKER_COUNT = 2;
+
+    size_t budgetBytes;
+    PromoteCallback onPromoted;
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::unordered_map<int, Entry> entries;
+    std::unordered_map<uint64_t, Blob> blobs;  // Keyed by VideoFrame::bufferId
+    std::list<int> lruOrder;  // front = least recently used
+    size_t usedBytes = 0;
+
+    std::deque<PendingFrame> compressQueue;
+    std::deque<int> promoteQueue;
+    std::unordered_set<int> promotePending;
+
+    std::vector<std::thread> workers;
+    bool shouldStop = false;
+
+    void workerTask();
+    void addEntry(int frameIndex, uint64_t bufferId);  // Must be called with mutex locked
+    void removeEntry(std::unordered_map<int, Entry>::iterator it);  // Must be called with mutex locked
+    void evictToBudget();  // Must be called with mutex locked
+
+    static std::vector<uint8_t> compress(const VideoFrame& frame);
+    static bool decompress(const std::vector<uint8_t>& blob, VideoFrame& frame);
+};
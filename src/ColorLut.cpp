@@ -0,0 +1,193 @@
+#include "ColorLut.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <SDL2/SDL.h>
+#include "GlShader.h"
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[ColorLut] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+constexpr int MAX_SIZE = 256;
+}
+
+bool ColorLut::parseCube(const std::string& path, Table& table, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "can't open " + path;
+        return false;
+    }
+
+    table = Table();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        std::istringstream fields(line.substr(start));
+        if (std::isalpha((unsigned char)line[start])) {
+            std::string keyword;
+            fields >> keyword;
+            if (keyword == "LUT_3D_SIZE") {
+                fields >> table.size;
+                if (table.size < 2 || table.size > MAX_SIZE) {
+                    error = "LUT_3D_SIZE out of range";
+                    return false;
+                }
+                table.rgb.reserve((size_t)table.size * table.size * table.size * 3);
+            } else if (keyword == "LUT_1D_SIZE") {
+                error = "1D LUTs aren't supported";
+                return false;
+            } else if (keyword == "DOMAIN_MIN") {
+                fields >> table.domainMin[0] >> table.domainMin[1] >> table.domainMin[2];
+            } else if (keyword == "DOMAIN_MAX") {
+                fields >> table.domainMax[0] >> table.domainMax[1] >> table.domainMax[2];
+            } else if (keyword == "LUT_3D_INPUT_RANGE") {
+                float low = 0.0f, high = 1.0f;
+                fields >> low >> high;
+                std::fill(table.domainMin, table.domainMin + 3, low);
+                std::fill(table.domainMax, table.domainMax + 3, high);
+            }
+            // TITLE and vendor keywords: nothing to do
+            continue;
+        }
+
+        float r, g, b;
+        if (!(fields >> r >> g >> b)) {
+            error = "bad entry on line " + std::to_string(lineNumber);
+            return false;
+        }
+        if (table.size == 0) {
+            error = "entries before LUT_3D_SIZE";
+            return false;
+        }
+        table.rgb.push_back(r);
+        table.rgb.push_back(g);
+        table.rgb.push_back(b);
+    }
+
+    size_t expected = (size_t)table.size * table.size * table.size * 3;
+    if (table.size == 0 || table.rgb.size() != expected) {
+        error = "expected " + std::to_string(expected / 3) + " entries, found " + std::to_string(table.rgb.size() / 3);
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (table.domainMax[i] <= table.domainMin[i]) {
+            error = "empty DOMAIN";
+            return false;
+        }
+    }
+    return true;
+}
+
+ColorLut::~ColorLut() {
+    if (texture) {
+        GlShader::setColorLut(0, scale, offset);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+bool ColorLut::init() {
+    if (!GlShader::load() || !GlShader::hasColorLut()) {
+        DEBUG_PRINT("No GLSL or 3D textures on this context - colour LUTs unavailable");
+        return false;
+    }
+    gles = GlShader::getDialect() == GlShader::Dialect::Gles100;
+    texImage3D = reinterpret_cast<PFNGLTEXIMAGE3DPROC>(
+        SDL_GL_GetProcAddress(gles ? "glTexImage3DOES" : "glTexImage3D"));
+    if (!texImage3D) {
+        DEBUG_PRINT("glTexImage3D missing - colour LUTs unavailable");
+        return false;
+    }
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_3D, texture);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_3D, 0);
+    return true;
+}
+
+bool ColorLut::load(const std::string& lutPath) {
+    if (!texture) return false;
+
+    Table table;
+    std::string error;
+    if (!parseCube(lutPath, table, error)) {
+        DEBUG_PRINT("Can't load " << lutPath << ": " << error);
+        return false;
+    }
+
+    // 16-bit texels on desktop GL; GLES 2 only has 8-bit 3D textures
+    glBindTexture(GL_TEXTURE_3D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (gles) {
+        std::vector<uint8_t> texels(table.rgb.size());
+        for (size_t i = 0; i < texels.size(); i++) {
+            texels[i] = (uint8_t)(std::min(std::max(table.rgb[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+        texImage3D(GL_TEXTURE_3D, 0, GL_RGB, table.size, table.size, table.size, 0,
+                   GL_RGB, GL_UNSIGNED_BYTE, texels.data());
+    } else {
+        std::vector<uint16_t> texels(table.rgb.size());
+        for (size_t i = 0; i < texels.size(); i++) {
+            texels[i] = (uint16_t)(std::min(std::max(table.rgb[i], 0.0f), 1.0f) * 65535.0f + 0.5f);
+        }
+        texImage3D(GL_TEXTURE_3D, 0, GL_RGB16, table.size, table.size, table.size, 0,
+                   GL_RGB, GL_UNSIGNED_SHORT, texels.data());
+    }
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    // Domain onto the texel centres: the first and last entries sit half a texel in
+    size = table.size;
+    for (int i = 0; i < 3; i++) {
+        scale[i] = (float)(size - 1) / size / (table.domainMax[i] - table.domainMin[i]);
+        offset[i] = 0.5f / size - table.domainMin[i] * scale[i];
+    }
+
+    path = lutPath;
+    std::error_code ignored;
+    loadedWriteTime = std::filesystem::last_write_time(path, ignored);
+    publish();
+    DEBUG_PRINT("Loaded " << path << " (" << size << "^3)" << (bypass ? " - bypassed" : ""));
+    return true;
+}
+
+void ColorLut::unload() {
+    if (size == 0) return;
+    size = 0;
+    path.clear();
+    publish();
+    DEBUG_PRINT("Colour LUT off");
+}
+
+void ColorLut::reloadIfChanged() {
+    if (path.empty()) return;
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (!error && writeTime != loadedWriteTime) {
+        // A failed parse (file still being written) retries at the next change
+        loadedWriteTime = writeTime;
+        load(path);
+    }
+}
+
+void ColorLut::setBypass(bool enabled) {
+    bypass = enabled;
+    publish();
+    DEBUG_PRINT((bypass ? "Bypassed" : "Applied"));
+}
+
+void ColorLut::publish() {
+    GlShader::setColorLut(size > 0 && !bypass ? texture : 0, scale, offset);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// 3D colour lookup table from a .cube file (the Resolve/Adobe text format),
+// held in a GL 3D texture. Every quad shader ends in GlShader's outputColor(),
+// which applies it with one trilinear fetch - no CPU pass over the frames.
+// Swapped at runtime by load()ing another file (or the same one rewritten).
+class ColorLut {
+public:
+    struct Table {
+        int size = 0;
+        std::vector<float> rgb;  // size^3 entries, red fastest
+        float domainMin[3] = {0.0f, 0.0f, 0.0f};
+        float domainMax[3] = {1.0f, 1.0f, 1.0f};
+    };
+    // False with error set on a malformed file or a 1D LUT
+    static bool parseCube(const std::string& path, Table& table, std::string& error);
+
+    ColorLut() = default;
+    ~ColorLut();
+
+    // Needs the renderer's context current. False (logged) without 3D textures
+    // (GLES 2 lacking GL_OES_texture_3D) - LUTs can't be used then.
+    bool init();
+
+    // Parse and upload; on failure the current LUT (if any) stays
+    bool load(const std::string& path);
+    void unload();
+
+    // Re-load the current file if it was rewritten since it was loaded
+    void reloadIfChanged();
+
+    // Bypass keeps the table but stops applying it (A/B comparison on site)
+    void setBypass(bool enabled);
+    bool isBypassed() const { return bypass; }
+
+    bool isLoaded() const { return size > 0; }
+    const std::string& getPath() const { return path; }
+
+private:
+    void publish();
+
+    GLuint texture = 0;
+    int size = 0;
+    float scale[3] = {1.0f, 1.0f, 1.0f};  // rgb * scale + offset = texture coordinate
+    float offset[3] = {0.0f, 0.0f, 0.0f};
+    bool bypass = false;
+    bool gles = false;
+
+    std::string path;
+    std::filesystem::file_time_type loadedWriteTime;
+    PFNGLTEXIMAGE3DPROC texImage3D = nullptr;  // glTexImage3DOES on GLES
+};
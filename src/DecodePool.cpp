@@ -0,0 +1,192 @@
+#include "DecodePool.h"
+#include <iostream>
+#include <algorithm>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[DecodePool] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+// Index of the pool worker running on this thread (-1 = not a pool thread)
+thread_local int currentWorker = -1;
+}
+
+int DecodePool::configuredThreads = 0;
+int DecodePool::expectedClients = 1;
+
+void DecodePool::configure(int threads, int clients) {
+    configuredThreads = threads;
+    expectedClients = std::max(1, clients);
+}
+
+DecodePool& DecodePool::instance() {
+    static DecodePool pool(configuredThreads);
+    return pool;
+}
+
+DecodePool::DecodePool(int threads) {
+    if (threads <= 0) {
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i]->thread = std::thread(&DecodePool::workerTask, this, i);
+    }
+    DEBUG_PRINT("Started " << threads << " workers (earliest deadline first, work stealing)");
+}
+
+DecodePool::~DecodePool() {
+    shouldStop = true;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        workAvailable.notify_all();
+    }
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void DecodePool::submit(const void* owner, Clock::time_point deadline, Job job, Clock::time_point notBefore) {
+    // Jobs submitted from a worker (a decoder rescheduling itself, or the
+    // converts it spawns) stay on that worker's queue
+    size_t index = (currentWorker >= 0) ? (size_t)currentWorker
+                                        : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->queue.push_back({deadline, notBefore, owner, std::move(job)});
+    }
+    std::lock_guard<std::mutex> lock(idleMutex);
+    submitEpoch++;
+    workAvailable.notify_one();
+}
+
+void DecodePool::removeOwner(const void* owner) {
+    while (true) {
+        bool running = false;
+        for (auto& worker : workers) {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            auto& queue = worker->queue;
+            queue.erase(std::remove_if(queue.begin(), queue.end(),
+                                       [owner](const QueuedJob& job) { return job.owner == owner; }),
+                        queue.end());
+            running = running || worker->runningOwner == owner;
+        }
+        if (!running) return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void DecodePool::registerClient() {
+    clients.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DecodePool::unregisterClient() {
+    clients.fetch_sub(1, std::memory_order_relaxed);
+}
+
+int DecodePool::codecThreadsPerContext() const {
+    int sharing = std::max(expectedClients, clients.load(std::memory_order_relaxed));
+    return std::max(1, (int)workers.size() / sharing);
+}
+
+DecodePool::Stats DecodePool::getStats() const {
+    Stats stats;
+    stats.jobsRun = jobsRun.load(std::memory_order_relaxed);
+    stats.jobsLate = jobsLate.load(std::memory_order_relaxed);
+    stats.steals = steals.load(std::memory_order_relaxed);
+    for (auto& worker : workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        stats.queued += worker->queue.size();
+    }
+    return stats;
+}
+
+// Pick the earliest-deadline eligible job, preferring our own queue on ties.
+// On success the job is removed and marked running on worker index.
+bool DecodePool::takeJob(size_t index, QueuedJob& taken, Clock::time_point& nextEligible) {
+    auto now = Clock::now();
+    nextEligible = Clock::time_point::max();
+
+    size_t bestWorker = workers.size();
+    Clock::time_point bestDeadline = Clock::time_point::max();
+
+    for (size_t offset = 0; offset < workers.size(); offset++) {
+        size_t candidate = (index + offset) % workers.size();
+        std::lock_guard<std::mutex> lock(workers[candidate]->mutex);
+        for (const auto& job : workers[candidate]->queue) {
+            if (job.notBefore > now) {
+                nextEligible = std::min(nextEligible, job.notBefore);
+                continue;
+            }
+            if (job.deadline < bestDeadline || bestWorker == workers.size()) {
+                bestDeadline = job.deadline;
+                bestWorker = candidate;
+            }
+        }
+    }
+    if (bestWorker == workers.size()) return false;
+
+    // std::lock takes both without risking deadlock against a worker stealing from us
+    Worker& victim = *workers[bestWorker];
+    Worker& self = *workers[index];
+    std::unique_lock<std::mutex> victimLock(victim.mutex, std::defer_lock);
+    std::unique_lock<std::mutex> selfLock(self.mutex, std::defer_lock);
+    if (&victim == &self) {
+        victimLock.lock();
+    } else {
+        std::lock(victimLock, selfLock);
+    }
+
+    // The queue may have changed since the scan - take whatever is best there now
+    auto& queue = victim.queue;
+    auto best = queue.end();
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        if (it->notBefore > now) continue;
+        if (best == queue.end() || it->deadline < best->deadline) best = it;
+    }
+    if (best == queue.end()) return false;
+
+    taken = std::move(*best);
+    queue.erase(best);
+    self.runningOwner = taken.owner;
+    if (&victim != &self) {
+        steals.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void DecodePool::workerTask(size_t index) {
+    currentWorker = (int)index;
+
+    while (!shouldStop) {
+        uint64_t seenEpoch;
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            seenEpoch = submitEpoch;
+        }
+
+        QueuedJob job;
+        Clock::time_point nextEligible;
+        if (!takeJob(index, job, nextEligible)) {
+            // Nothing runnable: sleep until the next delayed job or a submit
+            std::unique_lock<std::mutex> lock(idleMutex);
+            auto wakeAt = std::min(nextEligible, Clock::now() + std::chrono::milliseconds(50));
+            workAvailable.wait_until(lock, wakeAt, [&] { return submitEpoch != seenEpoch || shouldStop; });
+            continue;
+        }
+
+        if (Clock::now() > job.deadline) {
+            jobsLate.fetch_add(1, std::memory_order_relaxed);
+        }
+        job.job();
+        jobsRun.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->runningOwner = nullptr;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Process-wide worker pool for decode and convert jobs from every
+// VideoPlayer. Jobs carry a presentation deadline and always run earliest
+// deadline first across all players: a worker prefers its own queue (the
+// player's codec state stays warm on one core) but steals any job due sooner
+// from the others. When the machine can't keep up, every player falls behind
+// by the same amount instead of one starving the rest.
+class DecodePool {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Job = std::function<void()>;
+
+    // Worker count (0 = one per core) and how many players will share the
+    // pool. Call before the first instance().
+    static void configure(int threads, int expectedClients = 1);
+    static DecodePool& instance();
+
+    ~DecodePool();
+
+    // Queue a job. owner tags it for removeOwner(); notBefore delays it
+    // (e.g. an idle decoder polling again later).
+    void submit(const void* owner, Clock::time_point deadline, Job job,
+                Clock::time_point notBefore = Clock::time_point{});
+
+    // Drop owner's queued jobs and wait for its running ones to finish.
+    // Jobs may resubmit themselves while this runs; they are dropped too.
+    void removeOwner(const void* owner);
+
+    // Players sharing the pool, for splitting the codec thread budget
+    void registerClient();
+    void unregisterClient();
+
+    // libavcodec threads per codec context: the pool's size split between the
+    // clients (at least the expected ones, so the first player to open its
+    // codecs doesn't take every core). A player decodes on one of its two
+    // contexts at a time, and its decode job's worker waits while the codec
+    // threads run, so decoding stays within the pool's size. Converts on the
+    // other workers come on top - lower decodeThreads or set the threading
+    // counts explicitly to leave cores for something else.
+    int codecThreadsPerContext() const;
+
+    int getThreadCount() const { return (int)workers.size(); }
+
+    struct Stats {
+        uint64_t jobsRun = 0;
+        uint64_t jobsLate = 0;   // Started after their deadline
+        uint64_t steals = 0;     // Taken from another worker's queue
+        size_t queued = 0;
+    };
+    Stats getStats() const;
+
+private:
+    explicit DecodePool(int threads);
+
+    struct QueuedJob {
+        Clock::time_point deadline;
+        Clock::time_point notBefore;
+        const void* owner;
+        Job job;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::vector<QueuedJob> queue;    // Small - scanned linearly for the earliest deadline
+        const void* runningOwner = nullptr;  // Under mutex
+        std::thread thread;
+    };
+
+    static int configuredThreads;
+    static int expectedClients;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> shouldStop{false};
+    std::atomic<unsigned> nextWorker{0};
+    std::atomic<int> clients{0};
+
+    std::mutex idleMutex;
+    std::condition_variable workAvailable;
+    uint64_t submitEpoch = 0;  // Under idleMutex - catches submits that race with a worker going idle
+
+    std::atomic<uint64_t> jobsRun{0};
+    std::atomic<uint64_t> jobsLate{0};
+    std::atomic<uint64_t> steals{0};
+
+    void workerTask(size_t index);
+    bool takeJob(size_t index, QueuedJob& taken, Clock::time_point& nextEligible);
+};
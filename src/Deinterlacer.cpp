@@ -0,0 +1,124 @@
+#include "Deinterlacer.h"
+#include <iostream>
+#include "GlShader.h"
+#include "GlRenderer.h"
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[Deinterlacer] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+using namespace GlShader;
+
+namespace {
+const char* FRAGMENT_SHADER = R"(
+uniform sampler2D current;
+uniform sampler2D previous;
+uniform float field;   // Parity of the lines shown as-is
+uniform float lines;
+uniform float motionAdaptive;
+
+void main() {
+    vec2 tc = texCoord;
+    float line = floor(tc.y * lines);
+    vec2 here = vec2(tc.x, (line + 0.5) / lines);
+    vec3 woven = texture2D(current, here).rgb;
+    if (mod(line, 2.0) == field) {
+        FRAG_COLOR = outputColor(woven);
+        return;
+    }
+
+    vec3 above = texture2D(current, vec2(tc.x, (line - 0.5) / lines)).rgb;
+    vec3 below = texture2D(current, vec2(tc.x, (line + 1.5) / lines)).rgb;
+    vec3 bob = 0.5 * (above + below);
+
+    // Same line one frame earlier: unchanged means static, safe to weave
+    float motion = 1.0;
+    if (motionAdaptive > 0.5) {
+        vec3 diff = abs(woven - texture2D(previous, here).rgb);
+        motion = smoothstep(0.02, 0.08, max(diff.r, max(diff.g, diff.b)));
+    }
+    FRAG_COLOR = outputColor(mix(woven, bob, motion));
+}
+)";
+}
+
+Deinterlacer::Mode Deinterlacer::parseMode(const std::string& name) {
+    if (name == "off") return Mode::Off;
+    if (name == "bob") return Mode::Bob;
+    return Mode::Motion;
+}
+
+Deinterlacer::~Deinterlacer() {
+    if (previousTexture) glDeleteTextures(1, &previousTexture);
+    if (program) deleteProgram(program);
+}
+
+bool Deinterlacer::init() {
+    if (!GlShader::load()) {
+        DEBUG_PRINT("GLSL not available - interlaced sources are shown woven");
+        return false;
+    }
+    program = buildQuadProgram(FRAGMENT_SHADER, "Deinterlacer");
+    if (!program) return false;
+
+    fieldLocation = getUniformLocation(program, "field");
+    linesLocation = getUniformLocation(program, "lines");
+    motionLocation = getUniformLocation(program, "motionAdaptive");
+    useProgram(program);
+    uniform1i(getUniformLocation(program, "current"), 0);
+    uniform1i(getUniformLocation(program, "previous"), 1);
+    useProgram(0);
+
+    glGenTextures(1, &previousTexture);
+    glBindTexture(GL_TEXTURE_2D, previousTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    DEBUG_PRINT("Shader deinterlacer ready");
+    return true;
+}
+
+void Deinterlacer::setPrevious(const VideoFrame* frame) {
+    if (!frame || frame->format != VideoFrame::RGB24) {
+        previousBufferId = 0;
+        return;
+    }
+    if (frame->bufferId == previousBufferId && frame->width == previousWidth && frame->height == previousHeight) {
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, previousTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, frame->width, frame->height, 0,
+                 GL_RGB, GL_UNSIGNED_BYTE, frame->pixels());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    previousBufferId = frame->bufferId;
+    previousWidth = frame->width;
+    previousHeight = frame->height;
+}
+
+void Deinterlacer::draw(GLuint currentTexture, const VideoFrame& frame, int field, Mode mode,
+                        GlRenderer& renderer) {
+    bool motionAdaptive = mode == Mode::Motion && previousBufferId != 0 &&
+                          previousWidth == frame.width && previousHeight == frame.height;
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, previousTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, currentTexture);
+
+    useQuadProgram(program);
+    uniform1f(fieldLocation, (float)field);
+    uniform1f(linesLocation, (float)frame.height);
+    uniform1f(motionLocation, motionAdaptive ? 1.0f : 0.0f);
+
+    renderer.drawQuad();
+
+    useProgram(0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <GL/gl.h>
+
+#include "VideoFrame.h"
+
+class GlRenderer;
+
+// Shader deinterlacing for interlaced (broadcast) RGB24 frames, one field
+// per output frame so 50i plays as 50p.
+//   Bob:    the field's lines, the other field interpolated from them.
+//   Motion: where the other field's line matches the previous frame it is
+//           woven back in at full resolution; where it moved, bob is used.
+// High-bit-depth frames bob inside YuvPlaneRenderer instead.
+class Deinterlacer {
+public:
+    enum class Mode { Off, Bob, Motion };
+    static Mode parseMode(const std::string& name);
+
+    Deinterlacer() = default;
+    ~Deinterlacer();
+
+    // Needs the GL context current. False if shaders aren't available.
+    bool init();
+    bool isReady() const { return program != 0; }
+
+    // The frame before the current one, for motion detection. Re-uploaded
+    // only when the buffer changes; nullptr (not cached) falls back to bob.
+    void setPrevious(const VideoFrame* frame);
+
+    // Draw the current frame (already on currentTexture) on the renderer's
+    // quad, showing one field (0 = top = even lines)
+    void draw(GLuint currentTexture, const VideoFrame& frame, int field, Mode mode, GlRenderer& renderer);
+
+private:
+    GLuint program = 0;
+    GLint fieldLocation = -1;
+    GLint linesLocation = -1;
+    GLint motionLocation = -1;
+
+    GLuint previousTexture = 0;
+    uint64_t previousBufferId = 0;  // 0 = nothing usable uploaded
+    int previousWidth = 0;
+    int previousHeight = 0;
+};
@@ -0,0 +1,96 @@
+#include "FrameBlender.h"
+#include <iostream>
+#include "GlShader.h"
+#include "GlRenderer.h"
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[FrameBlender] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+using namespace GlShader;
+
+namespace {
+const char* FRAGMENT_SHADER = R"(
+uniform sampler2D current;
+uniform sampler2D next;
+uniform float phase;
+
+void main() {
+    vec3 color = texture2D(current, texCoord).rgb;
+    if (phase > 0.0) {
+        color = mix(color, texture2D(next, texCoord).rgb, phase);
+    }
+    FRAG_COLOR = outputColor(color);
+}
+)";
+}
+
+FrameBlender::~FrameBlender() {
+    if (nextTexture) glDeleteTextures(1, &nextTexture);
+    if (program) deleteProgram(program);
+}
+
+bool FrameBlender::init() {
+    if (!GlShader::load()) {
+        DEBUG_PRINT("GLSL not available - frames are shown without blending");
+        return false;
+    }
+    program = buildQuadProgram(FRAGMENT_SHADER, "FrameBlender");
+    if (!program) return false;
+
+    phaseLocation = getUniformLocation(program, "phase");
+    useProgram(program);
+    uniform1i(getUniformLocation(program, "current"), 0);
+    uniform1i(getUniformLocation(program, "next"), 1);
+    useProgram(0);
+
+    // Sampled on the same quad as the current frame, so filtered the same way
+    glGenTextures(1, &nextTexture);
+    glBindTexture(GL_TEXTURE_2D, nextTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    DEBUG_PRINT("Frame blending ready");
+    return true;
+}
+
+void FrameBlender::setNext(const VideoFrame* frame) {
+    if (!frame || frame->format != VideoFrame::RGB24) {
+        nextBufferId = 0;
+        return;
+    }
+    if (frame->bufferId == nextBufferId && frame->width == nextWidth && frame->height == nextHeight) {
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, nextTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, frame->width, frame->height, 0,
+                 GL_RGB, GL_UNSIGNED_BYTE, frame->pixels());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    nextBufferId = frame->bufferId;
+    nextWidth = frame->width;
+    nextHeight = frame->height;
+}
+
+void FrameBlender::draw(GLuint currentTexture, const VideoFrame& frame, float phase, GlRenderer& renderer) {
+    bool blend = nextBufferId != 0 && nextWidth == frame.width && nextHeight == frame.height;
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, nextTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, currentTexture);
+
+    useQuadProgram(program);
+    uniform1f(phaseLocation, blend ? phase : 0.0f);
+
+    renderer.drawQuad();
+
+    useProgram(0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
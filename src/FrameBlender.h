@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <GL/gl.h>
+
+#include "VideoFrame.h"
+
+class GlRenderer;
+
+// Temporal resampling for content slower than the display (24/25/30fps on
+// 50/60Hz): instead of holding each frame for an uneven number of refreshes,
+// every refresh shows the current frame cross-faded into the next one by the
+// transport's position between them. RGB24 progressive frames only.
+class FrameBlender {
+public:
+    FrameBlender() = default;
+    ~FrameBlender();
+
+    // Needs the GL context current. False if shaders aren't available.
+    bool init();
+    bool isReady() const { return program != 0; }
+
+    // The frame after the current one. Re-uploaded only when the buffer
+    // changes; nullptr (not cached yet) shows the current frame alone.
+    void setNext(const VideoFrame* frame);
+
+    // Draw the current frame (already on currentTexture) on the renderer's
+    // quad, phase (0..1) of the way to the next one
+    void draw(GLuint currentTexture, const VideoFrame& frame, float phase, GlRenderer& renderer);
+
+private:
+    GLuint program = 0;
+    GLint phaseLocation = -1;
+
+    GLuint nextTexture = 0;
+    uint64_t nextBufferId = 0;  // 0 = nothing usable uploaded
+    int nextWidth = 0;
+    int nextHeight = 0;
+};
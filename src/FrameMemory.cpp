@@ -0,0 +1,269 @@
+#include "FrameMemory.h"
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[FrameMemory] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+struct Pool {
+    std::mutex mutex;
+    FrameMemory::Mode mode = FrameMemory::Mode::Default;
+    bool locked = false;
+    size_t slotBytes = 0;     // Requested size served by slots
+    size_t mappedBytes = 0;   // Actual mapping size per slot (page rounded)
+    size_t totalSlots = 0;
+    std::vector<void*> freeSlots;
+    std::unordered_set<void*> slotAddresses;  // Every mapped slot, free or in use
+    bool loggedGrowth = false;
+};
+
+Pool& pool() {
+    static Pool instance;
+    return instance;
+}
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Slot-sized requests are those the pool was reserved for; anything much
+// smaller (thumbnails, metadata) would waste a whole slot
+bool fitsSlot(const Pool& p, size_t bytes) {
+    return p.slotBytes > 0 && bytes <= p.slotBytes && bytes > p.slotBytes / 2;
+}
+
+void* mapHugeTlb(size_t bytes) {
+#ifdef MAP_HUGETLB
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    flags |= (21 << MAP_HUGE_SHIFT);  // 2MiB pages
+#endif
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    return mapping == MAP_FAILED ? nullptr : mapping;
+#else
+    (void)bytes;
+    return nullptr;
+#endif
+}
+
+void* mapTransparentHuge(size_t bytes) {
+    // Over-allocate so the slot can start on a 2MiB boundary, then trim
+    size_t span = bytes + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = roundUp(start, HUGE_PAGE_SIZE);
+    if (aligned > start) munmap(raw, aligned - start);
+    size_t tail = (start + span) - (aligned + bytes);
+    if (tail > 0) munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+
+    void* mapping = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(mapping, bytes, MADV_HUGEPAGE);
+#endif
+    return mapping;
+}
+
+void* mapDefault(size_t bytes) {
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return mapping == MAP_FAILED ? nullptr : mapping;
+}
+
+// Map, pre-fault and optionally lock one slot. Must be called with the pool mutex held.
+void* mapSlot(Pool& p) {
+    void* mapping = nullptr;
+
+    if (p.mode == FrameMemory::Mode::HugeTLB) {
+        mapping = mapHugeTlb(p.mappedBytes);
+        if (!mapping) {
+            DEBUG_PRINT("MAP_HUGETLB failed (" << std::strerror(errno)
+                        << ") - reserve pages via vm.nr_hugepages; falling back to transparent huge pages");
+            p.mode = FrameMemory::Mode::TransparentHugePages;
+        }
+    }
+    if (!mapping && p.mode == FrameMemory::Mode::TransparentHugePages) {
+        mapping = mapTransparentHuge(p.mappedBytes);
+        if (!mapping) {
+            DEBUG_PRINT("Huge page mapping failed - falling back to regular pages");
+            p.mode = FrameMemory::Mode::Default;
+        }
+    }
+    if (!mapping) {
+        mapping = mapDefault(p.mappedBytes);
+    }
+    if (!mapping) return nullptr;
+
+    // Touch every page now so the first decode into it doesn't fault
+    long pageSize = sysconf(_SC_PAGESIZE);
+    volatile uint8_t* bytes = static_cast<uint8_t*>(mapping);
+    for (size_t offset = 0; offset < p.mappedBytes; offset += pageSize) {
+        bytes[offset] = 0;
+    }
+
+    if (p.locked && mlock(mapping, p.mappedBytes) != 0) {
+        DEBUG_PRINT("mlock failed (" << std::strerror(errno)
+                    << ") - raise LimitMEMLOCK; continuing with unlocked frame memory");
+        p.locked = false;
+    }
+
+    p.totalSlots++;
+    p.slotAddresses.insert(mapping);
+    return mapping;
+}
+
+} // namespace
+
+FrameMemory::Mode FrameMemory::parseMode(const std::string& name) {
+    if (name == "thp") return Mode::TransparentHugePages;
+    if (name == "hugetlb") return Mode::HugeTLB;
+    return Mode::Default;
+}
+
+const char* FrameMemory::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::TransparentHugePages: return "thp";
+        case Mode::HugeTLB: return "hugetlb";
+        default: return "default";
+    }
+}
+
+void FrameMemory::configure(Mode mode, bool lockMemory) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    p.mode = mode;
+    p.locked = lockMemory;
+}
+
+void FrameMemory::reserve(size_t slotBytes, size_t slotCount) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    if (p.slotBytes == 0) {
+        p.slotBytes = slotBytes;
+        size_t alignment = (p.mode == Mode::Default) ? (size_t)sysconf(_SC_PAGESIZE) : HUGE_PAGE_SIZE;
+        p.mappedBytes = roundUp(slotBytes, alignment);
+    } else if (p.slotBytes != slotBytes) {
+        DEBUG_PRINT("Pool already sized for " << p.slotBytes << " byte frames - "
+                    << slotBytes << " byte frames will use the heap");
+        return;
+    }
+
+    PageFaults before = pageFaults();
+    auto startTime = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < slotCount; i++) {
+        void* slot = mapSlot(p);
+        if (!slot) {
+            DEBUG_PRINT("Could only reserve " << i << " of " << slotCount << " slots");
+            break;
+        }
+        p.freeSlots.push_back(slot);
+    }
+
+    PageFaults after = pageFaults();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+
+    DEBUG_PRINT("Reserved " << p.totalSlots << " slots x " << p.mappedBytes / 1024 << " KiB ("
+                << (p.totalSlots * p.mappedBytes) / (1024 * 1024) << " MB, "
+                << modeName(p.mode) << (p.locked ? ", locked" : "") << ") in "
+                << elapsed.count() << " ms");
+    DEBUG_PRINT("Page faults during reserve: minor " << before.minor << " -> " << after.minor
+                << ", major " << before.major << " -> " << after.major);
+}
+
+size_t FrameMemory::trim(size_t keepFree) {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    size_t released = 0;
+    while (p.freeSlots.size() > keepFree) {
+        void* slot = p.freeSlots.back();
+        p.freeSlots.pop_back();
+        p.slotAddresses.erase(slot);
+        munmap(slot, p.mappedBytes);  // Also drops any mlock
+        p.totalSlots--;
+        released++;
+    }
+    if (released > 0) {
+        // Regrowing is expected after a trim - allow the message again
+        p.loggedGrowth = false;
+        DEBUG_PRINT("Released " << released << " free slots (" << (released * p.mappedBytes) / (1024 * 1024)
+                    << " MB), " << p.totalSlots << " remain");
+    }
+    return released;
+}
+
+void* FrameMemory::allocate(size_t bytes) {
+    Pool& p = pool();
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        if (fitsSlot(p, bytes)) {
+            if (!p.freeSlots.empty()) {
+                void* slot = p.freeSlots.back();
+                p.freeSlots.pop_back();
+                return slot;
+            }
+            // Pool exhausted - grow rather than fail (logged once)
+            if (!p.loggedGrowth) {
+                DEBUG_PRINT("Pool exhausted at " << p.totalSlots << " slots - growing on demand");
+                p.loggedGrowth = true;
+            }
+            void* slot = mapSlot(p);
+            if (slot) return slot;
+            throw std::bad_alloc();
+        }
+    }
+    return ::operator new(bytes);
+}
+
+void FrameMemory::deallocate(void* pointer, size_t /*bytes*/) {
+    if (!pointer) return;
+
+    Pool& p = pool();
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        if (p.slotAddresses.count(pointer)) {
+            p.freeSlots.push_back(pointer);
+            return;
+        }
+    }
+    ::operator delete(pointer);
+}
+
+FrameMemory::PageFaults FrameMemory::pageFaults() {
+    PageFaults faults;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        faults.minor = usage.ru_minflt;
+        faults.major = usage.ru_majflt;
+    }
+    return faults;
+}
+
+FrameMemory::Stats FrameMemory::getStats() {
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    Stats stats;
+    stats.slotBytes = p.mappedBytes;
+    stats.totalSlots = p.totalSlots;
+    stats.freeSlots = p.freeSlots.size();
+    stats.mode = p.mode;
+    stats.locked = p.locked;
+    return stats;
+}
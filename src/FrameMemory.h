@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+
+// Process-wide pool for frame-sized pixel buffers.
+// Slots are mmap'ed up front (optionally from 2MiB huge pages), pre-faulted
+// and mlock'ed, so the decoder and the GL driver never take page faults on
+// frame memory during a show. Allocations that don't fit a slot use the heap.
+class FrameMemory {
+public:
+    enum class Mode {
+        Default,                // Plain anonymous mmap, 4KiB pages
+        TransparentHugePages,   // 2MiB-aligned mmap + madvise(MADV_HUGEPAGE)
+        HugeTLB                 // MAP_HUGETLB from the reserved pool (vm.nr_hugepages)
+    };
+
+    static Mode parseMode(const std::string& name);
+    static const char* modeName(Mode mode);
+
+    // Pick the backing for pool slots and whether to mlock them.
+    // Call once at startup, before the first reserve().
+    static void configure(Mode mode, bool lockMemory);
+
+    // Pre-fault (and lock) slotCount slots of slotBytes. The first call fixes
+    // the slot size; later calls with the same size add slots.
+    static void reserve(size_t slotBytes, size_t slotCount);
+
+    // Unmap free slots beyond keepFree, returning their memory to the system
+    // (e.g. after the cache budget shrinks). Returns the number of slots released.
+    static size_t trim(size_t keepFree);
+
+    static void* allocate(size_t bytes);
+    static void deallocate(void* pointer, size_t bytes);
+
+    struct PageFaults {
+        long minor = 0;
+        long major = 0;
+    };
+    static PageFaults pageFaults();
+
+    struct Stats {
+        size_t slotBytes = 0;
+        size_t totalSlots = 0;
+        size_t freeSlots = 0;
+        Mode mode = Mode::Default;
+        bool locked = false;
+    };
+    static Stats getStats();
+};
+
+// std::allocator replacement for frame buffers. Also skips value-initialisation
+// on resize() - every byte is overwritten by sws_scale anyway.
+template <typename T>
+struct FrameAllocator {
+    using value_type = T;
+
+    FrameAllocator() = default;
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(FrameMemory::allocate(n * sizeof(T)));
+    }
+    void deallocate(T* pointer, size_t n) noexcept {
+        FrameMemory::deallocate(pointer, n * sizeof(T));
+    }
+
+    template <typename U>
+    void construct(U* pointer) noexcept {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args) {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>&) const noexcept { return false; }
+};
@@ -0,0 +1,61 @@
+#include "FrameRegion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+void FrameRegion::cropPlanes(const AVFrame* frame, const uint8_t* data[4]) const {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get((AVPixelFormat)frame->format);
+    int steps[4] = {0, 0, 0, 0};
+    if (desc) av_image_fill_max_pixsteps(steps, nullptr, desc);
+    // Palette formats carry the palette in plane 1; bitstream formats can't be offset per pixel
+    bool croppable = desc && !(desc->flags & AV_PIX_FMT_FLAG_BITSTREAM);
+    int planes = (desc && (desc->flags & AV_PIX_FMT_FLAG_PAL)) ? 1 : 4;
+
+    for (int plane = 0; plane < 4; plane++) {
+        data[plane] = frame->data[plane];
+        if (!data[plane] || !croppable || plane >= planes || (x == 0 && y == 0)) continue;
+        bool chroma = plane == 1 || plane == 2;
+        int shiftX = chroma ? desc->log2_chroma_w : 0;
+        int shiftY = chroma ? desc->log2_chroma_h : 0;
+        data[plane] += (ptrdiff_t)(y >> shiftY) * frame->linesize[plane] + (ptrdiff_t)(x >> shiftX) * steps[plane];
+    }
+}
+
+FrameRegion RegionOfInterest::resolve(int sourceWidth, int sourceHeight) const {
+    FrameRegion region = rect;
+    if (wallColumns > 0) {
+        // The picture spans the whole wall, bezels included: each tile is
+        // one display's share of columns + (columns - 1) bezel gaps
+        int rows = std::max(wallRows, 1);
+        float spanX = wallColumns + (wallColumns - 1) * bezelX;
+        float spanY = rows + (rows - 1) * bezelY;
+        region.x = (int)std::lround(sourceWidth * wallColumn * (1.0f + bezelX) / spanX);
+        region.y = (int)std::lround(sourceHeight * wallRow * (1.0f + bezelY) / spanY);
+        region.width = (int)std::lround(sourceWidth / spanX);
+        region.height = (int)std::lround(sourceHeight / spanY);
+    }
+    if (region.isWhole()) return FrameRegion{0, 0, sourceWidth, sourceHeight};
+
+    region.x = std::min(std::max(region.x, 0), sourceWidth - 2) & ~1;
+    region.y = std::min(std::max(region.y, 0), sourceHeight - 2) & ~1;
+    region.width = std::max(std::min(region.width, sourceWidth - region.x) & ~1, 2);
+    region.height = std::max(std::min(region.height, sourceHeight - region.y) & ~1, 2);
+    return region;
+}
+
+bool RegionOfInterest::parseRect(const std::string& text, FrameRegion& rect) {
+    return std::sscanf(text.c_str(), " %d , %d , %d , %d", &rect.x, &rect.y, &rect.width, &rect.height) == 4;
+}
+
+bool RegionOfInterest::parsePair(const std::string& text, int& first, int& second) {
+    return std::sscanf(text.c_str(), " %d , %d", &first, &second) == 2;
+}
+
+bool RegionOfInterest::parsePair(const std::string& text, float& first, float& second) {
+    return std::sscanf(text.c_str(), " %f , %f", &first, &second) == 2;
+}
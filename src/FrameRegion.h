@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+// Rectangle of the decoded picture a node keeps (its tile of a video wall):
+// conversion, the caches and the texture upload cover only this part.
+struct FrameRegion {
+    int x = 0;
+    int y = 0;
+    int width = 0;   // 0 = the whole frame
+    int height = 0;
+
+    bool isWhole() const { return width <= 0 || height <= 0; }
+
+    // frame's plane pointers moved to the region's top-left corner (with
+    // frame->linesize they address just the region)
+    void cropPlanes(const AVFrame* frame, const uint8_t* data[4]) const;
+};
+
+// What a node asks for: an explicit rectangle, or its tile of a video wall
+// with the picture running on behind the bezels
+struct RegionOfInterest {
+    FrameRegion rect;  // Source pixels
+    int wallColumns = 0;  // > 0: wall tile instead of rect
+    int wallRows = 1;
+    int wallColumn = 0;   // This node's tile, from the top left
+    int wallRow = 0;
+    float bezelX = 0.0f;  // Gap between displays' pictures, as a fraction of a display's width
+    float bezelY = 0.0f;  // ... and height
+
+    bool isSet() const { return wallColumns > 0 || !rect.isWhole(); }
+
+    // The rectangle in a sourceWidth x sourceHeight frame, clamped, with
+    // origin and size even (chroma subsampling); the whole frame if unset
+    FrameRegion resolve(int sourceWidth, int sourceHeight) const;
+
+    // "x,y,width,height"; "columns,rows"; "column,row"; "x,y" - false if it doesn't parse
+    static bool parseRect(const std::string& text, FrameRegion& rect);
+    static bool parsePair(const std::string& text, int& first, int& second);
+    static bool parsePair(const std::string& text, float& first, float& second);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "VideoFrame.h"
+
+// Handle for one VideoPlayer::requestFrame() call. The player fulfils it from
+// the cache or from its decode engine, earliest deadline first; the caller can
+// poll, block, or cancel it once the frame is no longer wanted.
+class FrameRequest {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FrameRequest(int frameIndex, Clock::time_point deadline)
+        : frameIndex(frameIndex), deadline(deadline) {}
+
+    int getFrameIndex() const { return frameIndex; }
+    Clock::time_point getDeadline() const { return deadline; }
+
+    // Drop the request; the decoder stops working towards it and waiters wake with nullptr
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frame) return;
+        cancelled = true;
+        ready.notify_all();
+    }
+
+    bool isCancelled() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cancelled;
+    }
+
+    // The player couldn't produce the frame (past the real end of the stream,
+    // dropped by the decoder); waiters wake with nullptr
+    bool isFailed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return failed;
+    }
+
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frame != nullptr;
+    }
+
+    // The frame if it has arrived, else nullptr (never blocks)
+    std::shared_ptr<const VideoFrame> tryGet() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frame;
+    }
+
+    // Block until the frame arrives or the request is cancelled or failed
+    std::shared_ptr<const VideoFrame> wait() const {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return frame || cancelled || failed; });
+        return frame;
+    }
+
+    // As wait(), but give up at timeout (nullptr) - the request stays queued
+    std::shared_ptr<const VideoFrame> waitUntil(Clock::time_point timeout) const {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait_until(lock, timeout, [this] { return frame || cancelled || failed; });
+        return frame;
+    }
+
+    // Called by the player. Returns false if the request was already done or cancelled.
+    bool fulfil(std::shared_ptr<const VideoFrame> decoded) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frame || cancelled || failed) return false;
+        frame = std::move(decoded);
+        ready.notify_all();
+        return true;
+    }
+
+    // Called by the player. Returns false if the request was already done or cancelled.
+    bool fail() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (frame || cancelled || failed) return false;
+        failed = true;
+        ready.notify_all();
+        return true;
+    }
+
+private:
+    const int frameIndex;
+    const Clock::time_point deadline;
+
+    mutable std::mutex mutex;
+    mutable std::condition_variable ready;
+    std::shared_ptr<const VideoFrame> frame;
+    bool cancelled = false;
+    bool failed = false;
+};
+
+using FrameRequestHandle = std::shared_ptr<FrameRequest>;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Shared-memory frame ring between a producer process (generative engine,
+// capture tool) and the player. The producer creates the memory (shm_open,
+// or a memfd the player opens via /proc/<pid>/fd/<n>), writes this header at
+// offset 0 and the slot pixel data from dataOffset on.
+//
+// Protocol (all fields seq_cst atomics, so both sides must be 64-bit Linux):
+//   Producer, for its n-th frame (n = 1, 2, ...):
+//     pick a slot that is not the one in `latest`; store sequence 2n-1 to it,
+//     then check readers == 0 (else restore the old sequence and pick
+//     another); write pixels; store sequence 2n; store
+//     latest = (2n << 8) | slot.
+//   Consumer:
+//     read latest; readers++ on that slot; re-read the slot sequence - if it
+//     changed or is odd, readers-- and retry; read pixels; readers--.
+// The producer only ever writes to slots nobody is reading and the consumer
+// always gets the newest complete frame, so with >= 3 slots neither side waits
+// (4 if the player shows ring memory directly - it holds the displayed slot).
+// A player killed mid-read leaves its readers count raised; a producer may
+// reset counts that stay raised for seconds.
+namespace FrameRing {
+
+constexpr char MAGIC[8] = {'C', 'V', 'P', 'R', 'I', 'N', 'G', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t MAX_SLOTS = 8;
+
+enum PixelFormat : uint32_t {
+    RGB24 = 0,
+    RGBA = 1,
+    YUV420P = 2,
+    NV12 = 3
+};
+
+struct Slot {
+    std::atomic<uint64_t> sequence;   // Odd while the producer writes
+    std::atomic<uint32_t> readers;
+    uint32_t reserved;
+    int64_t producerTimeUs;           // Informational - frames are stamped on arrival
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;                  // PixelFormat
+    uint32_t stride;                  // Row bytes of RGB formats (0 = packed); YUV planes are always packed
+    uint64_t slotBytes;               // Bytes per slot, at least one frame
+    uint64_t dataOffset;              // Offset of slot 0 from the start of the mapping
+    std::atomic<uint64_t> latest;     // (sequence << 8) | slot, 0 = nothing published yet
+    Slot slots[MAX_SLOTS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring atomics must be address-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring atomics must be address-free");
+
+}
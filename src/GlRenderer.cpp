@@ -0,0 +1,349 @@
+#include "GlRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <SDL2/SDL.h>
+#include "GlShader.h"
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[GlRenderer] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+template <typename T>
+bool loadFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(SDL_GL_GetProcAddress(name));
+    return function != nullptr;
+}
+
+// Plain RGB texture; a shader so the output stage can be applied
+GLuint buildTextureProgram() {
+    GLuint program = GlShader::buildQuadProgram(R"(
+uniform sampler2D image;
+void main() {
+    FRAG_COLOR = outputColor(texture2D(image, texCoord).rgb);
+}
+)", "GlRenderer");
+    if (program) {
+        GlShader::useProgram(program);
+        GlShader::uniform1i(GlShader::getUniformLocation(program, "image"), 0);
+        GlShader::useProgram(0);
+    }
+    return program;
+}
+
+void printContext(const char* backend) {
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    const GLubyte* version = glGetString(GL_VERSION);
+    DEBUG_PRINT(backend << " renderer on " << (renderer ? (const char*)renderer : "?")
+                << " (" << (version ? (const char*)version : "?") << ")");
+}
+
+// GL 2.1 fixed function - the original render path
+class LegacyGlRenderer : public GlRenderer {
+public:
+    LegacyGlRenderer() : GlRenderer(Backend::Legacy) {}
+
+    ~LegacyGlRenderer() override {
+        if (textureProgram) GlShader::deleteProgram(textureProgram);
+    }
+
+    bool init() override {
+        GlShader::setDialect(GlShader::Dialect::Glsl120);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        glEnable(GL_TEXTURE_2D);
+        // Only for the output stage and warp meshes - plain frames stay on
+        // fixed function, and drivers without GLSL just can't apply them
+        if (GlShader::load()) {
+            textureProgram = buildTextureProgram();
+        }
+        printContext("Legacy GL");
+        return true;
+    }
+
+    bool hasPixelBuffers() const override { return true; }
+    bool has16BitTextures() const override { return true; }
+
+    void drawTexture(GLuint texture) override {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        if (textureProgram && (GlShader::isOutputStageActive() || warpMesh)) {
+            GlShader::useQuadProgram(textureProgram);
+            drawQuad();
+            GlShader::useProgram(0);
+        } else {
+            drawQuad();
+        }
+    }
+
+    void drawQuad() override {
+        if (!meshVertices.empty()) {
+            glBegin(GL_TRIANGLES);
+            for (size_t i = 0; i + 4 <= meshVertices.size(); i += 4) {
+                glTexCoord2f(meshVertices[i + 2], meshVertices[i + 3]);
+                glVertex2f(meshVertices[i], meshVertices[i + 1]);
+            }
+            glEnd();
+            return;
+        }
+        float left = sourceU(0.0f), right = sourceU(1.0f);
+        float top = sourceV(0.0f), bottom = sourceV(1.0f);
+        glBegin(GL_QUADS);
+        glTexCoord2f(left, top); glVertex2f(quad.x, quad.y);
+        glTexCoord2f(right, top); glVertex2f(quad.x + quad.width, quad.y);
+        glTexCoord2f(right, bottom); glVertex2f(quad.x + quad.width, quad.y + quad.height);
+        glTexCoord2f(left, bottom); glVertex2f(quad.x, quad.y + quad.height);
+        glEnd();
+    }
+
+protected:
+    void layoutChanged(bool windowResized) override {
+        meshVertices = meshTriangles();
+        if (!windowResized) return;
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0, windowWidth, windowHeight, 0, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+    }
+
+private:
+    GLuint textureProgram = 0;
+    std::vector<float> meshVertices;  // Empty without a warp mesh
+};
+
+// GL 3.3 core / GLES 2.0: one VBO holding the quad (or warp mesh) in clip
+// space, rewritten on layout changes
+class VboGlRenderer : public GlRenderer {
+public:
+    explicit VboGlRenderer(Backend backend) : GlRenderer(backend) {}
+
+    ~VboGlRenderer() override {
+        if (textureProgram) GlShader::deleteProgram(textureProgram);
+        if (vbo) deleteBuffers(1, &vbo);
+        if (vao) deleteVertexArrays(1, &vao);
+    }
+
+    bool init() override {
+        bool core = backend == Backend::Core;
+        GlShader::setDialect(core ? GlShader::Dialect::Glsl330 : GlShader::Dialect::Gles100);
+        if (!GlShader::load()) return false;
+
+        bool loaded = loadFunction(genBuffers, "glGenBuffers") && loadFunction(deleteBuffers, "glDeleteBuffers") &&
+                      loadFunction(bindBuffer, "glBindBuffer") && loadFunction(bufferData, "glBufferData") &&
+                      loadFunction(vertexAttribPointer, "glVertexAttribPointer") &&
+                      loadFunction(enableVertexAttribArray, "glEnableVertexAttribArray");
+        // Core profile can't draw without a vertex array object
+        if (core) {
+            loaded = loaded && loadFunction(genVertexArrays, "glGenVertexArrays") &&
+                     loadFunction(bindVertexArray, "glBindVertexArray") &&
+                     loadFunction(deleteVertexArrays, "glDeleteVertexArrays");
+        }
+        if (!loaded) return false;
+
+        textureProgram = buildTextureProgram();
+        if (!textureProgram) return false;
+
+        genBuffers(1, &vbo);
+        bindBuffer(GL_ARRAY_BUFFER, vbo);
+        bufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+        if (core) {
+            genVertexArrays(1, &vao);
+            bindVertexArray(vao);
+            setAttributes();
+            bindVertexArray(0);
+        }
+        bindBuffer(GL_ARRAY_BUFFER, 0);
+
+        printContext(core ? "GL 3.3 core" : "GLES 2");
+        return true;
+    }
+
+    bool hasPixelBuffers() const override { return backend == Backend::Core; }
+    bool has16BitTextures() const override { return backend == Backend::Core; }
+
+    void drawTexture(GLuint texture) override {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        GlShader::useQuadProgram(textureProgram);
+        drawQuad();
+        GlShader::useProgram(0);
+    }
+
+    void drawQuad() override {
+        GLenum mode = warpMesh ? GL_TRIANGLES : GL_TRIANGLE_STRIP;
+        GLsizei count = (GLsizei)(vertices.size() / 4);
+        if (vao) {
+            bindVertexArray(vao);
+            glDrawArrays(mode, 0, count);
+            bindVertexArray(0);
+        } else {
+            bindBuffer(GL_ARRAY_BUFFER, vbo);
+            setAttributes();
+            glDrawArrays(mode, 0, count);
+            bindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    }
+
+protected:
+    void layoutChanged(bool) override {
+        if (warpMesh) {
+            vertices = meshTriangles();
+        } else {
+            // Strip order TL, TR, BL, BR
+            float left = quad.x, right = quad.x + quad.width;
+            float top = quad.y, bottom = quad.y + quad.height;
+            float u0 = sourceU(0.0f), u1 = sourceU(1.0f);
+            float v0 = sourceV(0.0f), v1 = sourceV(1.0f);
+            vertices = {
+                left,  top,    u0, v0,
+                right, top,    u1, v0,
+                left,  bottom, u0, v1,
+                right, bottom, u1, v1,
+            };
+        }
+        // Window pixels (top-left origin) -> clip space
+        for (size_t i = 0; i + 4 <= vertices.size(); i += 4) {
+            vertices[i] = vertices[i] / windowWidth * 2.0f - 1.0f;
+            vertices[i + 1] = 1.0f - vertices[i + 1] / windowHeight * 2.0f;
+        }
+
+        bindBuffer(GL_ARRAY_BUFFER, vbo);
+        bufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+        bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+private:
+    void setAttributes() {
+        const GLsizei stride = 4 * sizeof(float);
+        vertexAttribPointer(GlShader::POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, stride, nullptr);
+        vertexAttribPointer(GlShader::TEXCOORD_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, stride,
+                            reinterpret_cast<const void*>(2 * sizeof(float)));
+        enableVertexAttribArray(GlShader::POSITION_ATTRIBUTE);
+        enableVertexAttribArray(GlShader::TEXCOORD_ATTRIBUTE);
+    }
+
+    PFNGLGENBUFFERSPROC genBuffers = nullptr;
+    PFNGLDELETEBUFFERSPROC deleteBuffers = nullptr;
+    PFNGLBINDBUFFERPROC bindBuffer = nullptr;
+    PFNGLBUFFERDATAPROC bufferData = nullptr;
+    PFNGLVERTEXATTRIBPOINTERPROC vertexAttribPointer = nullptr;
+    PFNGLENABLEVERTEXATTRIBARRAYPROC enableVertexAttribArray = nullptr;
+    PFNGLGENVERTEXARRAYSPROC genVertexArrays = nullptr;
+    PFNGLBINDVERTEXARRAYPROC bindVertexArray = nullptr;
+    PFNGLDELETEVERTEXARRAYSPROC deleteVertexArrays = nullptr;
+
+    GLuint textureProgram = 0;
+    GLuint vbo = 0;
+    GLuint vao = 0;  // Core only
+    std::vector<float> vertices = std::vector<float>(16, 0.0f);  // x, y, u, v per vertex
+};
+}
+
+std::vector<GlRenderer::Backend> GlRenderer::parseBackends(const std::string& name) {
+    if (name == "core") return {Backend::Core};
+    if (name == "gles2") return {Backend::Gles2};
+    if (name == "legacy") return {Backend::Legacy};
+    return {Backend::Core, Backend::Gles2, Backend::Legacy};
+}
+
+const char* GlRenderer::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::Core: return "core";
+        case Backend::Gles2: return "gles2";
+        case Backend::Legacy: return "legacy";
+    }
+    return "?";
+}
+
+void GlRenderer::setContextAttributes(Backend backend) {
+    switch (backend) {
+        case Backend::Core:
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+            break;
+        case Backend::Gles2:
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+            break;
+        case Backend::Legacy:
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, 0);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+            break;
+    }
+}
+
+std::unique_ptr<GlRenderer> GlRenderer::create(Backend backend) {
+    if (backend == Backend::Legacy) return std::make_unique<LegacyGlRenderer>();
+    return std::make_unique<VboGlRenderer>(backend);
+}
+
+void GlRenderer::setScaleMode(ScaleMode mode) {
+    scaleMode = mode;
+    videoWidth = videoHeight = 0;  // Recompute at the next setLayout()
+}
+
+void GlRenderer::setSourceRect(float x, float y, float width, float height) {
+    source.x = std::min(std::max(x, 0.0f), 1.0f);
+    source.y = std::min(std::max(y, 0.0f), 1.0f);
+    source.width = std::min(std::max(width, 0.0f), 1.0f - source.x);
+    source.height = std::min(std::max(height, 0.0f), 1.0f - source.y);
+    if (source.width <= 0.0f || source.height <= 0.0f) source = OutputLayout::Quad{0.0f, 0.0f, 1.0f, 1.0f};
+    videoWidth = videoHeight = 0;  // Recompute at the next setLayout()
+}
+
+void GlRenderer::setWarpMesh(std::shared_ptr<const WarpMesh> mesh) {
+    warpMesh = std::move(mesh);
+    if (windowWidth > 0 && videoWidth > 0) layoutChanged(false);
+}
+
+void GlRenderer::setLayout(int newWindowWidth, int newWindowHeight, int newVideoWidth, int newVideoHeight) {
+    // Every call: with several outputs the blend mask spans whichever one is drawing
+    GlShader::setOutputSize(newWindowWidth, newWindowHeight);
+    bool windowResized = newWindowWidth != windowWidth || newWindowHeight != windowHeight;
+    if (!windowResized && newVideoWidth == videoWidth && newVideoHeight == videoHeight) return;
+    if (newWindowWidth <= 0 || newWindowHeight <= 0 || newVideoWidth <= 0 || newVideoHeight <= 0) return;
+
+    windowWidth = newWindowWidth;
+    windowHeight = newWindowHeight;
+    videoWidth = newVideoWidth;
+    videoHeight = newVideoHeight;
+    if (windowResized) glViewport(0, 0, windowWidth, windowHeight);
+
+    // The source rect's shape decides the fit
+    int sourceWidth = std::max(1, (int)std::lround(videoWidth * source.width));
+    int sourceHeight = std::max(1, (int)std::lround(videoHeight * source.height));
+    quad = OutputLayout::fit(scaleMode, windowWidth, windowHeight, sourceWidth, sourceHeight);
+    layoutChanged(windowResized);
+}
+
+std::vector<float> GlRenderer::meshTriangles() const {
+    std::vector<float> triangles;
+    if (!warpMesh || quad.width <= 0.0f || quad.height <= 0.0f) return triangles;
+
+    const WarpMesh& mesh = *warpMesh;
+    auto add = [&](const WarpMesh::Point& point) {
+        triangles.push_back(point.x * windowWidth);
+        triangles.push_back(point.y * windowHeight);
+        triangles.push_back(sourceU((point.u * windowWidth - quad.x) / quad.width));
+        triangles.push_back(sourceV((point.v * windowHeight - quad.y) / quad.height));
+    };
+    triangles.reserve((size_t)(mesh.columns - 1) * (mesh.rows - 1) * 6 * 4);
+    for (int row = 0; row + 1 < mesh.rows; row++) {
+        for (int column = 0; column + 1 < mesh.columns; column++) {
+            const WarpMesh::Point& topLeft = mesh.at(column, row);
+            const WarpMesh::Point& topRight = mesh.at(column + 1, row);
+            const WarpMesh::Point& bottomLeft = mesh.at(column, row + 1);
+            const WarpMesh::Point& bottomRight = mesh.at(column + 1, row + 1);
+            add(topLeft); add(topRight); add(bottomLeft);
+            add(topRight); add(bottomRight); add(bottomLeft);
+        }
+    }
+    return triangles;
+}
+
+void GlRenderer::clear() {
+    glClear(GL_COLOR_BUFFER_BIT);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <GL/gl.h>
+
+#include "OutputLayout.h"
+#include "WarpMesh.h"
+
+// Draws the video quad on the current GL context. Backends:
+//   Legacy: GL 2.1 fixed function (glOrtho + glBegin), for drivers without GLSL
+//   Core:   GL 3.3 core profile - a VBO quad and shaders
+//   Gles2:  GLES 2.0 (KMS/DRM boards) - same VBO path, ES shading language
+// The quad for the scale mode is worked out in setLayout() when the window or
+// video size changes, not every frame. With a warp mesh set, the quad becomes
+// the mesh's triangles (rebuilt at the same points). Shader stages
+// (YuvPlaneRenderer, Deinterlacer) bind their program and textures and call
+// drawQuad().
+class GlRenderer {
+public:
+    enum class Backend { Legacy, Core, Gles2 };
+    using ScaleMode = OutputLayout::ScaleMode;
+
+    // "auto" (core, then GLES 2, then legacy), "core", "gles2" or "legacy"
+    static std::vector<Backend> parseBackends(const std::string& name);
+    static const char* backendName(Backend backend);
+
+    // SDL GL attributes for the backend - before creating the window and context
+    static void setContextAttributes(Backend backend);
+    static std::unique_ptr<GlRenderer> create(Backend backend);
+
+    virtual ~GlRenderer() = default;
+
+    // Needs the backend's context current. False if it can't draw on it.
+    virtual bool init() = 0;
+    Backend getBackend() const { return backend; }
+
+    // Whether GL_PIXEL_UNPACK_BUFFER uploads work (not on GLES 2)
+    virtual bool hasPixelBuffers() const = 0;
+    // Whether 16-bit textures (YuvPlaneRenderer) work (not on GLES 2)
+    virtual bool has16BitTextures() const = 0;
+
+    void setScaleMode(ScaleMode mode);
+    // Part of the frame to show, as fractions of it (crop for one output of
+    // several); the scale mode fits this part. Default: the whole frame.
+    void setSourceRect(float x, float y, float width, float height);
+    // nullptr = the plain quad
+    void setWarpMesh(std::shared_ptr<const WarpMesh> mesh);
+    // Window (drawable) and video size; recomputes the quad only when one changed
+    void setLayout(int windowWidth, int windowHeight, int videoWidth, int videoHeight);
+
+    void clear();
+    // Plain RGB texture on the quad
+    virtual void drawTexture(GLuint texture) = 0;
+    // The quad (or warp mesh) with the caller's program and textures bound
+    virtual void drawQuad() = 0;
+
+protected:
+    explicit GlRenderer(Backend backend) : backend(backend) {}
+
+    // Quad or mesh moved (window pixels, top-left origin)
+    virtual void layoutChanged(bool windowResized) = 0;
+
+    // Texture coordinate of a point on the quad (0..1 across it)
+    float sourceU(float quadU) const { return source.x + quadU * source.width; }
+    float sourceV(float quadV) const { return source.y + quadV * source.height; }
+
+    // Warp mesh as triangles: x, y in window pixels and the texture
+    // coordinates per vertex (outside the source rect where the mesh shows the bars)
+    std::vector<float> meshTriangles() const;
+
+    Backend backend;
+    ScaleMode scaleMode = ScaleMode::Letterbox;
+    int windowWidth = 0;
+    int windowHeight = 0;
+    int videoWidth = 0;
+    int videoHeight = 0;
+    OutputLayout::Quad quad;
+    OutputLayout::Quad source{0.0f, 0.0f, 1.0f, 1.0f};  // Fractions of the frame
+    std::shared_ptr<const WarpMesh> warpMesh;
+};
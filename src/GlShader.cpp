@@ -0,0 +1,282 @@
+#include "GlShader.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <SDL2/SDL.h>
+
+namespace GlShader {
+
+PFNGLUSEPROGRAMPROC useProgram = nullptr;
+PFNGLDELETEPROGRAMPROC deleteProgram = nullptr;
+PFNGLGETUNIFORMLOCATIONPROC getUniformLocation = nullptr;
+PFNGLUNIFORM1IPROC uniform1i = nullptr;
+PFNGLUNIFORM1FPROC uniform1f = nullptr;
+PFNGLUNIFORM2FPROC uniform2f = nullptr;
+PFNGLUNIFORM3FPROC uniform3f = nullptr;
+PFNGLUNIFORMMATRIX3FVPROC uniformMatrix3fv = nullptr;
+
+namespace {
+Dialect currentDialect = Dialect::Glsl120;
+
+// Output stage state (colour LUT, blend mask), and where each quad program takes it
+GLuint colorLutTexture = 0;
+float colorLutScale[3] = {1.0f, 1.0f, 1.0f};
+float colorLutOffset[3] = {0.0f, 0.0f, 0.0f};
+GLuint blendMaskTexture = 0;
+float outputWidth = 1.0f;
+float outputHeight = 1.0f;
+struct OutputUniforms {
+    GLint colorLutEnabled = -1;
+    GLint colorLutScale = -1;
+    GLint colorLutOffset = -1;
+    GLint blendEnabled = -1;
+    GLint outputSize = -1;
+};
+std::unordered_map<GLuint, OutputUniforms> outputUniforms;
+
+PFNGLCREATESHADERPROC createShader = nullptr;
+PFNGLSHADERSOURCEPROC shaderSource = nullptr;
+PFNGLCOMPILESHADERPROC compileShader = nullptr;
+PFNGLGETSHADERIVPROC getShaderiv = nullptr;
+PFNGLGETSHADERINFOLOGPROC getShaderInfoLog = nullptr;
+PFNGLDELETESHADERPROC deleteShader = nullptr;
+PFNGLCREATEPROGRAMPROC createProgram = nullptr;
+PFNGLATTACHSHADERPROC attachShader = nullptr;
+PFNGLLINKPROGRAMPROC linkProgram = nullptr;
+PFNGLGETPROGRAMIVPROC getProgramiv = nullptr;
+PFNGLGETPROGRAMINFOLOGPROC getProgramInfoLog = nullptr;
+PFNGLBINDATTRIBLOCATIONPROC bindAttribLocation = nullptr;
+
+// Quads from glBegin/glTexCoord
+const char* FIXED_FUNCTION_VERTEX = R"(
+varying vec2 texCoord;
+void main() {
+    texCoord = gl_MultiTexCoord0.st;
+    gl_Position = ftransform();
+}
+)";
+
+// Quads from the VBO, positions already in clip space
+const char* ATTRIBUTE_VERTEX = R"(
+attribute vec2 position;
+attribute vec2 texCoordIn;
+varying vec2 texCoord;
+void main() {
+    texCoord = texCoordIn;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+
+// ES needs a default float precision; line maths on 1080+ rows wants highp
+const char* GLES_PREFIX = R"(#version 100
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#define FRAG_COLOR gl_FragColor
+)";
+
+// Last step of every quad shader: colour LUT (out-of-range coordinates clamp
+// to the edge texels, so no clamp here), then the blend mask in output space,
+// then black outside the picture - a warp mesh reaches into the bars.
+const char* OUTPUT_STAGE = R"(
+varying vec2 texCoord;
+#ifdef COLOR_LUT
+uniform sampler3D colorLut;
+uniform vec3 colorLutScale;
+uniform vec3 colorLutOffset;
+uniform float colorLutEnabled;
+#endif
+uniform sampler2D blendMask;
+uniform float blendEnabled;
+uniform vec2 outputSize;
+vec4 outputColor(vec3 rgb) {
+#ifdef COLOR_LUT
+    if (colorLutEnabled > 0.5) {
+        rgb = texture3D(colorLut, rgb * colorLutScale + colorLutOffset).rgb;
+    }
+#endif
+    if (blendEnabled > 0.5) {
+        rgb *= texture2D(blendMask, vec2(gl_FragCoord.x / outputSize.x, 1.0 - gl_FragCoord.y / outputSize.y)).rgb;
+    }
+    if (texCoord.x < 0.0 || texCoord.x > 1.0 || texCoord.y < 0.0 || texCoord.y > 1.0) {
+        rgb = vec3(0.0);
+    }
+    return vec4(rgb, 1.0);
+}
+)";
+
+template <typename T>
+bool loadFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(SDL_GL_GetProcAddress(name));
+    return function != nullptr;
+}
+
+GLuint compile(GLenum type, const std::string& source, const char* owner) {
+    GLuint shader = createShader(type);
+    const char* text = source.c_str();
+    shaderSource(shader, 1, &text, nullptr);
+    compileShader(shader);
+
+    GLint ok = GL_FALSE;
+    getShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = {};
+        getShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cout << "[" << owner << "] Shader compile failed: " << log << std::endl;
+        deleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+}
+
+void setDialect(Dialect dialect) {
+    currentDialect = dialect;
+}
+
+Dialect getDialect() {
+    return currentDialect;
+}
+
+bool load() {
+    return
+        loadFunction(createShader, "glCreateShader") && loadFunction(shaderSource, "glShaderSource") &&
+        loadFunction(compileShader, "glCompileShader") && loadFunction(getShaderiv, "glGetShaderiv") &&
+        loadFunction(getShaderInfoLog, "glGetShaderInfoLog") && loadFunction(deleteShader, "glDeleteShader") &&
+        loadFunction(createProgram, "glCreateProgram") && loadFunction(attachShader, "glAttachShader") &&
+        loadFunction(linkProgram, "glLinkProgram") && loadFunction(getProgramiv, "glGetProgramiv") &&
+        loadFunction(getProgramInfoLog, "glGetProgramInfoLog") && loadFunction(deleteProgram, "glDeleteProgram") &&
+        loadFunction(useProgram, "glUseProgram") && loadFunction(getUniformLocation, "glGetUniformLocation") &&
+        loadFunction(uniform1i, "glUniform1i") && loadFunction(uniform1f, "glUniform1f") &&
+        loadFunction(uniform2f, "glUniform2f") && loadFunction(uniform3f, "glUniform3f") &&
+        loadFunction(uniformMatrix3fv, "glUniformMatrix3fv") && loadFunction(bindAttribLocation, "glBindAttribLocation");
+}
+
+GLuint buildProgram(const std::string& vertexSource, const std::string& fragmentSource, const char* owner) {
+    GLuint vertex = compile(GL_VERTEX_SHADER, vertexSource, owner);
+    GLuint fragment = compile(GL_FRAGMENT_SHADER, fragmentSource, owner);
+    if (!vertex || !fragment) {
+        if (vertex) deleteShader(vertex);
+        if (fragment) deleteShader(fragment);
+        return 0;
+    }
+
+    GLuint program = createProgram();
+    attachShader(program, vertex);
+    attachShader(program, fragment);
+    bindAttribLocation(program, POSITION_ATTRIBUTE, "position");
+    bindAttribLocation(program, TEXCOORD_ATTRIBUTE, "texCoordIn");
+    linkProgram(program);
+    deleteShader(vertex);
+    deleteShader(fragment);
+
+    GLint ok = GL_FALSE;
+    getProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = {};
+        getProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cout << "[" << owner << "] Shader link failed: " << log << std::endl;
+        deleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+GLuint buildQuadProgram(const std::string& fragmentSource, const char* owner) {
+    bool lut = hasColorLut();
+    std::string output = std::string(lut ? "#define COLOR_LUT\n" : "") + OUTPUT_STAGE;
+    GLuint program = 0;
+    switch (currentDialect) {
+        case Dialect::Glsl330:
+            program = buildProgram(std::string("#version 330 core\n#define attribute in\n#define varying out\n") + ATTRIBUTE_VERTEX,
+                                   std::string("#version 330 core\n#define varying in\n#define texture2D texture\n"
+                                               "#define texture3D texture\n#define FRAG_COLOR fragColor\n"
+                                               "out vec4 fragColor;\n") + output + fragmentSource,
+                                   owner);
+            break;
+        case Dialect::Gles100: {
+            // The extension line must come straight after #version
+            std::string prefix = GLES_PREFIX;
+            if (lut) {
+                prefix.insert(prefix.find('\n') + 1,
+                              "#extension GL_OES_texture_3D : enable\nprecision mediump sampler3D;\n");
+            }
+            program = buildProgram(std::string(GLES_PREFIX) + ATTRIBUTE_VERTEX, prefix + output + fragmentSource, owner);
+            break;
+        }
+        case Dialect::Glsl120:
+        default:
+            program = buildProgram(std::string("#version 120\n") + FIXED_FUNCTION_VERTEX,
+                                   "#version 120\n#define FRAG_COLOR gl_FragColor\n" + output + fragmentSource, owner);
+            break;
+    }
+
+    outputUniforms.erase(program);
+    if (program) {
+        OutputUniforms& uniforms = outputUniforms[program];
+        uniforms.colorLutEnabled = getUniformLocation(program, "colorLutEnabled");
+        uniforms.colorLutScale = getUniformLocation(program, "colorLutScale");
+        uniforms.colorLutOffset = getUniformLocation(program, "colorLutOffset");
+        uniforms.blendEnabled = getUniformLocation(program, "blendEnabled");
+        uniforms.outputSize = getUniformLocation(program, "outputSize");
+        useProgram(program);
+        if (lut) uniform1i(getUniformLocation(program, "colorLut"), COLOR_LUT_TEXTURE_UNIT);
+        uniform1i(getUniformLocation(program, "blendMask"), BLEND_MASK_TEXTURE_UNIT);
+        useProgram(0);
+    }
+    return program;
+}
+
+void useQuadProgram(GLuint program) {
+    useProgram(program);
+    auto it = outputUniforms.find(program);
+    if (it == outputUniforms.end()) return;
+
+    const OutputUniforms& uniforms = it->second;
+    if (uniforms.colorLutEnabled >= 0) {
+        uniform1f(uniforms.colorLutEnabled, colorLutTexture ? 1.0f : 0.0f);
+        if (colorLutTexture) {
+            uniform3f(uniforms.colorLutScale, colorLutScale[0], colorLutScale[1], colorLutScale[2]);
+            uniform3f(uniforms.colorLutOffset, colorLutOffset[0], colorLutOffset[1], colorLutOffset[2]);
+            glActiveTexture(GL_TEXTURE0 + COLOR_LUT_TEXTURE_UNIT);
+            glBindTexture(GL_TEXTURE_3D, colorLutTexture);
+        }
+    }
+    uniform1f(uniforms.blendEnabled, blendMaskTexture ? 1.0f : 0.0f);
+    if (blendMaskTexture) {
+        uniform2f(uniforms.outputSize, outputWidth, outputHeight);
+        glActiveTexture(GL_TEXTURE0 + BLEND_MASK_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, blendMaskTexture);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+bool hasColorLut() {
+    // 3D textures are core since GL 1.2; GLES 2 needs the extension
+    return currentDialect != Dialect::Gles100 || SDL_GL_ExtensionSupported("GL_OES_texture_3D");
+}
+
+void setColorLut(GLuint texture, const float scale[3], const float offset[3]) {
+    colorLutTexture = texture;
+    for (int i = 0; i < 3; i++) {
+        colorLutScale[i] = scale[i];
+        colorLutOffset[i] = offset[i];
+    }
+}
+
+void setBlendMask(GLuint texture) {
+    blendMaskTexture = texture;
+}
+
+void setOutputSize(int width, int height) {
+    outputWidth = (float)std::max(width, 1);
+    outputHeight = (float)std::max(height, 1);
+}
+
+bool isOutputStageActive() {
+    return colorLutTexture != 0 || blendMaskTexture != 0;
+}
+
+}
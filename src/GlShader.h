@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// GL 2.0 shader entry points, loaded through SDL (the GL 1.x headers don't
+// prototype them), and program building for the shader-based render stages.
+namespace GlShader {
+
+extern PFNGLUSEPROGRAMPROC useProgram;
+extern PFNGLDELETEPROGRAMPROC deleteProgram;
+extern PFNGLGETUNIFORMLOCATIONPROC getUniformLocation;
+extern PFNGLUNIFORM1IPROC uniform1i;
+extern PFNGLUNIFORM1FPROC uniform1f;
+extern PFNGLUNIFORM2FPROC uniform2f;
+extern PFNGLUNIFORM3FPROC uniform3f;
+extern PFNGLUNIFORMMATRIX3FVPROC uniformMatrix3fv;
+
+// Shading language of the current context, set by the GlRenderer backend
+enum class Dialect {
+    Glsl120,  // GL 2.1, quads from glBegin (fixed-function inputs)
+    Glsl330,  // GL 3.3 core, quads from a VBO
+    Gles100   // GLES 2.0, quads from a VBO
+};
+void setDialect(Dialect dialect);
+Dialect getDialect();
+
+// Vertex attribute slots of the VBO quad
+constexpr GLuint POSITION_ATTRIBUTE = 0;
+constexpr GLuint TEXCOORD_ATTRIBUTE = 1;
+
+// Needs a current GL context; false if GLSL isn't available. Safe to call
+// repeatedly (re-resolves, so a fallback context gets its own pointers).
+bool load();
+
+// Compile and link; 0 on failure (logged with owner as the prefix)
+GLuint buildProgram(const std::string& vertexSource, const std::string& fragmentSource, const char* owner);
+
+// Program for the renderer's quad in the current dialect. The fragment
+// source reads texCoord, samples with texture2D() and writes
+// FRAG_COLOR = outputColor(rgb), the output stage (colour LUT, blend mask,
+// black outside the picture); the #version line, dialect shims, texCoord
+// and outputColor() are prepended.
+GLuint buildQuadProgram(const std::string& fragmentSource, const char* owner);
+
+// useProgram() for quad programs: also binds the output stage state
+void useQuadProgram(GLuint program);
+
+// Whether quad programs built now can sample a 3D LUT (not on GLES 2
+// without GL_OES_texture_3D)
+bool hasColorLut();
+// The LUT outputColor() applies (texture 0 = none): texture coordinate =
+// rgb * scale + offset. Set by ColorLut.
+void setColorLut(GLuint texture, const float scale[3], const float offset[3]);
+// RGB multiplier over the whole output, e.g. projector edge-blend ramps
+// (texture 0 = none). Set by BlendMask.
+void setBlendMask(GLuint texture);
+// Drawable size the blend mask is stretched over. Set by GlRenderer.
+void setOutputSize(int width, int height);
+// Whether plain textures need a shader for the output stage
+bool isOutputStageActive();
+
+// Texture units clear of the stages' own textures
+constexpr GLuint COLOR_LUT_TEXTURE_UNIT = 3;
+constexpr GLuint BLEND_MASK_TEXTURE_UNIT = 4;
+
+}
@@ -0,0 +1,87 @@
+#include "GopBoundary.h"
+
+namespace {
+// First VCL NAL unit type in an H.264 / HEVC packet, or -1. NAL units are
+// either length-prefixed (lengthSize bytes, from avcC / hvcC) or Annex B
+// start-code delimited (lengthSize 0).
+int firstVclNalType(const uint8_t* data, int size, int lengthSize, bool hevc) {
+    int position = 0;
+    while (position < size) {
+        int nalStart, nalSize;
+        if (lengthSize > 0) {
+            if (position + lengthSize > size) return -1;
+            nalSize = 0;
+            for (int i = 0; i < lengthSize; i++) nalSize = (nalSize << 8) | data[position + i];
+            nalStart = position + lengthSize;
+            if (nalSize <= 0 || nalSize > size - nalStart) return -1;
+            position = nalStart + nalSize;
+        } else {
+            // Next 00 00 01; the NAL runs to the start code after it
+            while (position + 3 <= size &&
+                   !(data[position] == 0 && data[position + 1] == 0 && data[position + 2] == 1)) {
+                position++;
+            }
+            if (position + 3 > size) return -1;
+            nalStart = position + 3;
+            nalSize = size - nalStart;
+            position = nalStart;
+        }
+        if (nalSize < 1) continue;
+
+        if (hevc) {
+            int type = (data[nalStart] >> 1) & 0x3f;
+            if (type < 32) return type;
+        } else {
+            int type = data[nalStart] & 0x1f;
+            if (type >= 1 && type <= 5) return type;
+        }
+    }
+    return -1;
+}
+
+// MPEG-2 GOP header (00 00 01 B8) / MPEG-4 Part 2 GOV header (00 00 01 B3):
+// closed flag set. No header: not a GOP start we can vouch for.
+bool hasClosedGopHeader(const uint8_t* data, int size, bool mpeg4) {
+    uint8_t code = mpeg4 ? 0xb3 : 0xb8;
+    for (int i = 0; i + 8 <= size; i++) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1 && data[i + 3] == code) {
+            // MPEG-2: 25-bit time code, then closed_gop. MPEG-4: 18-bit time code, then closed_gov.
+            return mpeg4 ? (data[i + 6] & 0x20) : (data[i + 7] & 0x40);
+        }
+    }
+    return false;
+}
+}
+
+bool GopBoundary::isClosed(const AVPacket* packet, const AVCodecParameters* codecParams) {
+    if (!(packet->flags & AV_PKT_FLAG_KEY)) return false;
+
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get(codecParams->codec_id);
+    if (descriptor && (descriptor->props & AV_CODEC_PROP_INTRA_ONLY)) return true;
+
+    const uint8_t* extradata = codecParams->extradata;
+    int extradataSize = codecParams->extradata_size;
+    switch (codecParams->codec_id) {
+        case AV_CODEC_ID_H264: {
+            // avcC: lengthSizeMinusOne in byte 4
+            int lengthSize = (extradataSize >= 5 && extradata[0] == 1) ? (extradata[4] & 3) + 1 : 0;
+            return firstVclNalType(packet->data, packet->size, lengthSize, false) == 5;  // IDR
+        }
+        case AV_CODEC_ID_HEVC: {
+            // hvcC: lengthSizeMinusOne in byte 21
+            int lengthSize = (extradataSize >= 23 && extradata[0] == 1) ? (extradata[21] & 3) + 1 : 0;
+            int type = firstVclNalType(packet->data, packet->size, lengthSize, true);
+            return type == 19 || type == 20;  // IDR_W_RADL, IDR_N_LP
+        }
+        case AV_CODEC_ID_MPEG2VIDEO:
+            return hasClosedGopHeader(packet->data, packet->size, false);
+        case AV_CODEC_ID_MPEG4:
+            return hasClosedGopHeader(packet->data, packet->size, true);
+        case AV_CODEC_ID_VP8:
+        case AV_CODEC_ID_VP9:
+        case AV_CODEC_ID_AV1:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+// Whether decoding can start afresh at a packet without losing pictures.
+// A keyframe isn't always enough: in an open GOP (H.264 recovery points,
+// HEVC CRA, MPEG-2 without closed_gop) the pictures that follow it in
+// decode order but show before it reference the previous GOP, so a new
+// decoder context started there drops or corrupts them.
+namespace GopBoundary {
+
+// True for a key packet that starts a closed GOP: an IDR picture, an MPEG-2 /
+// MPEG-4 GOP header with the closed flag, any keyframe of an intra-only codec
+// or of VP8 / VP9 / AV1 (their keyframes reset every reference). False for
+// anything else, including keyframes of codecs not parsed here.
+bool isClosed(const AVPacket* packet, const AVCodecParameters* codecParams);
+
+}
@@ -0,0 +1,95 @@
+#include "ImageSequence.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <regex>
+#include <utility>
+
+namespace {
+
+const char* IMAGE_EXTENSIONS[] = {
+    ".png", ".tif", ".tiff", ".jpg", ".jpeg", ".exr", ".dpx", ".bmp", ".tga", ".webp"
+};
+
+bool hasImageExtension(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return (char)std::tolower(c); });
+    for (const char* known : IMAGE_EXTENSIONS) {
+        if (extension == known) return true;
+    }
+    return false;
+}
+
+// Finds "%d" or "%0Nd" in name; returns false if there is none
+bool findFrameNumber(const std::string& name, size_t& start, size_t& length, int& digits) {
+    std::smatch match;
+    static const std::regex pattern("%(0?([0-9]+))?d");
+    if (!std::regex_search(name, match, pattern)) return false;
+    start = (size_t)match.position(0);
+    length = (size_t)match.length(0);
+    digits = match[2].matched ? std::stoi(match[2].str()) : 0;
+    return true;
+}
+
+std::string escapeRegex(const std::string& text) {
+    static const std::regex special(R"([.^$|()\[\]{}*+?\\])");
+    return std::regex_replace(text, special, R"(\$&)");
+}
+
+} // namespace
+
+namespace ImageSequence {
+
+bool isSequence(const std::string& path) {
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error)) return true;
+
+    size_t start, length;
+    int digits;
+    return findFrameNumber(std::filesystem::path(path).filename().string(), start, length, digits);
+}
+
+std::vector<std::string> resolve(const std::string& path) {
+    std::vector<std::string> files;
+    std::error_code error;
+
+    if (std::filesystem::is_directory(path, error)) {
+        for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+            if (entry.is_regular_file(error) && hasImageExtension(entry.path())) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    std::filesystem::path patternPath(path);
+    std::string name = patternPath.filename().string();
+    size_t start, length;
+    int digits;
+    if (!findFrameNumber(name, start, length, digits)) return files;
+
+    // "%04d" -> exactly four digits, "%d" -> any number of them
+    std::string numberRegex = digits > 0 ? "([0-9]{" + std::to_string(digits) + "})" : "([0-9]+)";
+    std::regex matcher(escapeRegex(name.substr(0, start)) + numberRegex + escapeRegex(name.substr(start + length)));
+
+    std::filesystem::path directory = patternPath.has_parent_path() ? patternPath.parent_path()
+                                                                    : std::filesystem::path(".");
+    std::vector<std::pair<long long, std::string>> numbered;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string candidate = entry.path().filename().string();
+        std::smatch match;
+        if (entry.is_regular_file(error) && std::regex_match(candidate, match, matcher)) {
+            numbered.emplace_back(std::stoll(match[1].str()), entry.path().string());
+        }
+    }
+
+    std::sort(numbered.begin(), numbered.end());
+    for (auto& frame : numbered) {
+        files.push_back(std::move(frame.second));
+    }
+    return files;
+}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Image sequences (PNG/TIFF/JPEG/EXR/DPX...) given as a directory or as a
+// printf-style pattern such as /shots/sh010/sh010.%04d.exr.
+namespace ImageSequence {
+
+// True for a directory, or a path containing a %d / %0Nd frame number
+bool isSequence(const std::string& path);
+
+// The frame files in playback order: a directory's images sorted by name,
+// or a pattern's matches sorted by frame number (gaps are skipped)
+std::vector<std::string> resolve(const std::string& path);
+
+}
@@ -0,0 +1,268 @@
+#include "IntraFrameDecoder.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[IntraFrameDecoder] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+bool IntraFrameDecoder::isIntraOnly(const AVCodecParameters* codecParams) {
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get(codecParams->codec_id);
+    return descriptor && (descriptor->props & AV_CODEC_PROP_INTRA_ONLY);
+}
+
+IntraFrameDecoder::IntraFrameDecoder(const std::string& videoPath, int streamIndex, double fps, int totalFrames)
+    : videoPath(videoPath), streamIndex(streamIndex), fps(fps), totalFrames(totalFrames) {
+    // The first context also provides the stream timing and the packet index
+    Context* context = openContext();
+    if (!context) return;
+
+    AVStream* stream = context->format->streams[streamIndex];
+    startPts = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+    timeBase = av_q2d(stream->time_base);
+
+    int entries = avformat_index_get_entries_count(stream);
+    if (entries >= totalFrames) {
+        frameTimestamps.reserve(entries);
+        for (int i = 0; i < entries; i++) {
+            frameTimestamps.push_back(avformat_index_get_entry(stream, i)->timestamp);
+        }
+    }
+
+    DEBUG_PRINT("All-intra stream - random access on parallel contexts ("
+                << (frameTimestamps.empty() ? "timestamps from frame rate" : "container index") << ")");
+    returnContext(context);
+}
+
+IntraFrameDecoder::IntraFrameDecoder(std::vector<std::string> files, const AVCodecParameters* codecParams)
+    : streamIndex(0), fps(0.0), totalFrames((int)files.size()), files(std::move(files)) {
+    sequenceParams = avcodec_parameters_alloc();
+    if (!sequenceParams || avcodec_parameters_copy(sequenceParams, codecParams) < 0) return;
+    readaheadIssued.assign(this->files.size(), false);
+
+    Context* context = openContext();
+    if (!context) return;
+    DEBUG_PRINT("Image sequence of " << totalFrames << " frames - one file per frame on parallel contexts");
+    returnContext(context);
+}
+
+IntraFrameDecoder::~IntraFrameDecoder() {
+    std::lock_guard<std::mutex> lock(contextsMutex);
+    for (Context* context : allContexts) {
+        closeContext(context);
+    }
+    allContexts.clear();
+    idleContexts.clear();
+    avcodec_parameters_free(&sequenceParams);
+}
+
+void IntraFrameDecoder::readahead(int firstFrame, int count) {
+    if (files.empty() || firstFrame < 0) return;
+    count = std::min(count, totalFrames);
+
+    std::vector<int> toRead;
+    {
+        std::lock_guard<std::mutex> lock(readaheadMutex);
+        // Frames the window has moved off may come round again (looping,
+        // a locate back) and need reading again by then
+        for (int frameIndex : readaheadWindow) {
+            int position = ((frameIndex - firstFrame) % totalFrames + totalFrames) % totalFrames;
+            if (position >= count) readaheadIssued[frameIndex] = false;
+        }
+        readaheadWindow.clear();
+        for (int i = 0; i < count; i++) {
+            int frameIndex = (firstFrame + i) % totalFrames;
+            readaheadWindow.push_back(frameIndex);
+            if (!readaheadIssued[frameIndex]) {
+                readaheadIssued[frameIndex] = true;
+                toRead.push_back(frameIndex);
+            }
+        }
+    }
+
+    for (int frameIndex : toRead) {
+        int fd = open(files[frameIndex].c_str(), O_RDONLY);
+        if (fd < 0) continue;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+}
+
+size_t IntraFrameDecoder::getContextCount() const {
+    std::lock_guard<std::mutex> lock(contextsMutex);
+    return allContexts.size();
+}
+
+IntraFrameDecoder::Context* IntraFrameDecoder::openContext() {
+    Context* context = new Context();
+
+    if (!files.empty()) {
+        const AVCodec* codec = avcodec_find_decoder(sequenceParams->codec_id);
+        context->codec = codec ? avcodec_alloc_context3(codec) : nullptr;
+        if (context->codec) context->codec->thread_count = 1;
+        if (!context->codec || avcodec_parameters_to_context(context->codec, sequenceParams) < 0 ||
+            avcodec_open2(context->codec, codec, nullptr) < 0) {
+            closeContext(context);
+            return nullptr;
+        }
+        context->packet = av_packet_alloc();
+        context->frame = av_frame_alloc();
+
+        std::lock_guard<std::mutex> lock(contextsMutex);
+        allContexts.push_back(context);
+        return context;
+    }
+
+    if (avformat_open_input(&context->format, videoPath.c_str(), nullptr, nullptr) < 0 ||
+        avformat_find_stream_info(context->format, nullptr) < 0 ||
+        streamIndex >= (int)context->format->nb_streams) {
+        closeContext(context);
+        return nullptr;
+    }
+
+    // Only our stream - don't demux audio we'd throw away
+    for (unsigned int i = 0; i < context->format->nb_streams; i++) {
+        if ((int)i != streamIndex) context->format->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    AVCodecParameters* codecParams = context->format->streams[streamIndex]->codecpar;
+    const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
+    context->codec = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!context->codec || avcodec_parameters_to_context(context->codec, codecParams) < 0) {
+        closeContext(context);
+        return nullptr;
+    }
+
+    // Parallelism comes from many contexts; each one outputs its frame straight away
+    context->codec->thread_count = 1;
+    if (avcodec_open2(context->codec, codec, nullptr) < 0) {
+        closeContext(context);
+        return nullptr;
+    }
+
+    context->packet = av_packet_alloc();
+    context->frame = av_frame_alloc();
+
+    std::lock_guard<std::mutex> lock(contextsMutex);
+    allContexts.push_back(context);
+    return context;
+}
+
+void IntraFrameDecoder::closeContext(Context* context) {
+    av_frame_free(&context->frame);
+    av_packet_free(&context->packet);
+    avcodec_free_context(&context->codec);
+    if (context->format) avformat_close_input(&context->format);
+    delete context;
+}
+
+IntraFrameDecoder::Context* IntraFrameDecoder::checkoutContext() {
+    {
+        std::lock_guard<std::mutex> lock(contextsMutex);
+        if (!idleContexts.empty()) {
+            Context* context = idleContexts.back();
+            idleContexts.pop_back();
+            return context;
+        }
+    }
+    return openContext();
+}
+
+void IntraFrameDecoder::returnContext(Context* context) {
+    std::lock_guard<std::mutex> lock(contextsMutex);
+    idleContexts.push_back(context);
+}
+
+int64_t IntraFrameDecoder::timestampForFrame(int frameIndex) const {
+    if (frameIndex < (int)frameTimestamps.size()) {
+        return frameTimestamps[frameIndex];
+    }
+    return startPts + (int64_t)std::llround(frameIndex / fps / timeBase);
+}
+
+int IntraFrameDecoder::frameIndexForTimestamp(int64_t timestamp) const {
+    return (int)std::llround((double)(timestamp - startPts) * timeBase * fps);
+}
+
+bool IntraFrameDecoder::decode(int frameIndex, const FrameCallback& onFrame) {
+    if (frameIndex < 0 || frameIndex >= totalFrames) return false;
+
+    Context* context = checkoutContext();
+    if (!context) return false;
+
+    if (!files.empty()) {
+        bool decoded = decodeFile(context, frameIndex, onFrame);
+        returnContext(context);
+        return decoded;
+    }
+
+    // Every frame is a keyframe, so the seek lands on the frame itself
+    bool decoded = false;
+    if (av_seek_frame(context->format, streamIndex, timestampForFrame(frameIndex), AVSEEK_FLAG_BACKWARD) >= 0) {
+        avcodec_flush_buffers(context->codec);
+
+        auto receive = [&]() {
+            while (!decoded && avcodec_receive_frame(context->codec, context->frame) >= 0) {
+                int64_t timestamp = context->frame->best_effort_timestamp;
+                int decodedIndex = (timestamp != AV_NOPTS_VALUE) ? frameIndexForTimestamp(timestamp) : frameIndex;
+                if (decodedIndex < frameIndex) continue;  // Seek landed short (inexact index)
+                onFrame(decodedIndex, context->frame);
+                decoded = true;
+            }
+        };
+
+        // A few packets at most: the seek may land a frame or two early
+        constexpr int MAX_PACKETS = 8;
+        int packets = 0;
+        while (!decoded && packets < MAX_PACKETS && av_read_frame(context->format, context->packet) >= 0) {
+            if (context->packet->stream_index == streamIndex) {
+                packets++;
+                if (avcodec_send_packet(context->codec, context->packet) >= 0) {
+                    receive();
+                }
+            }
+            av_packet_unref(context->packet);
+        }
+        if (!decoded && avcodec_send_packet(context->codec, nullptr) >= 0) {
+            receive();
+        }
+    }
+
+    returnContext(context);
+    return decoded;
+}
+
+// One image: open its file, decode its only packet
+bool IntraFrameDecoder::decodeFile(Context* context, int frameIndex, const FrameCallback& onFrame) {
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, files[frameIndex].c_str(), nullptr, nullptr) < 0) {
+        DEBUG_PRINT("Cannot open " << files[frameIndex]);
+        return false;
+    }
+
+    avcodec_flush_buffers(context->codec);
+    bool decoded = false;
+    auto receive = [&]() {
+        if (avcodec_receive_frame(context->codec, context->frame) >= 0) {
+            onFrame(frameIndex, context->frame);
+            decoded = true;
+        }
+    };
+
+    while (!decoded && av_read_frame(format, context->packet) >= 0) {
+        if (avcodec_send_packet(context->codec, context->packet) >= 0) {
+            receive();
+        }
+        av_packet_unref(context->packet);
+    }
+    if (!decoded && avcodec_send_packet(context->codec, nullptr) >= 0) {
+        receive();
+    }
+
+    avformat_close_input(&format);
+    return decoded;
+}
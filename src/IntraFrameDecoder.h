@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+// Random-access decoder for all-intra sources (ProRes, DNxHR, MJPEG, FFV1
+// intra, ...). No frame depends on another, so any frame is one seek and one
+// packet decode away, and frames can be decoded in any order on as many
+// threads as there are contexts: each decode() checks out its own demuxer +
+// single-threaded codec, opening a new one if all are busy.
+// Image sequences work the same way with one file per frame.
+class IntraFrameDecoder {
+public:
+    static bool isIntraOnly(const AVCodecParameters* codecParams);
+
+    IntraFrameDecoder(const std::string& videoPath, int streamIndex, double fps, int totalFrames);
+    // Image sequence: frame i is files[i]. codecParams describes the first image.
+    IntraFrameDecoder(std::vector<std::string> files, const AVCodecParameters* codecParams);
+    ~IntraFrameDecoder();
+
+    // Called with the decoded frame and its index (normally frameIndex itself)
+    using FrameCallback = std::function<void(int frameIndex, const AVFrame* frame)>;
+
+    // Decode one frame on the calling thread. Thread-safe; returns false on failure.
+    bool decode(int frameIndex, const FrameCallback& onFrame);
+
+    size_t getContextCount() const;
+
+    // Image sequences: ask the kernel to start reading these frames' files
+    // (posix_fadvise WILLNEED) so I/O overlaps decode. No-op for containers.
+    void readahead(int firstFrame, int count);
+
+private:
+    struct Context {
+        AVFormatContext* format = nullptr;
+        AVCodecContext* codec = nullptr;
+        AVPacket* packet = nullptr;
+        AVFrame* frame = nullptr;
+    };
+
+    std::string videoPath;
+    int streamIndex;
+    double fps;
+    int totalFrames;
+
+    // Exact frame timestamps from the container index, when it has one entry per frame
+    std::vector<int64_t> frameTimestamps;
+    int64_t startPts = 0;
+    double timeBase = 0.0;
+
+    mutable std::mutex contextsMutex;
+    std::vector<Context*> idleContexts;
+    std::vector<Context*> allContexts;
+
+    // Image sequence mode (files non-empty): contexts are codec-only and each
+    // decode opens its frame's file
+    std::vector<std::string> files;
+    AVCodecParameters* sequenceParams = nullptr;
+    std::mutex readaheadMutex;
+    std::vector<bool> readaheadIssued;  // Under readaheadMutex
+    std::vector<int> readaheadWindow;   // Frames of the last readahead() call, under readaheadMutex
+
+    bool decodeFile(Context* context, int frameIndex, const FrameCallback& onFrame);
+
+    Context* checkoutContext();
+    void returnContext(Context* context);
+    Context* openContext();
+    static void closeContext(Context* context);
+    int64_t timestampForFrame(int frameIndex) const;
+    int frameIndexForTimestamp(int64_t timestamp) const;
+};
@@ -53,6 +53,12 @@ jack_nframes_t JackTransportClient::getCurrentFrame() {
     return pos.frame;
 }
 
+jack_nframes_t JackTransportClient::getInterpolatedFrame() {
+    if (!client) return 0;
+
+    return jack_get_current_transport_frame(client);
+}
+
 bool JackTransportClient::isTransportRolling() {
     if (!client) return false;
 
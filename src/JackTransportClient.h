@@ -15,6 +15,10 @@ public:
     // Get current transport position in frames
     jack_nframes_t getCurrentFrame();
 
+    // Transport position estimated for this moment rather than the start of
+    // the current JACK period (which only advances once per period)
+    jack_nframes_t getInterpolatedFrame();
+
     // Get JACK transport state (rolling = playing, stopped = paused)
     bool isTransportRolling();
 
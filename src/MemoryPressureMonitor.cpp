@@ -0,0 +1,182 @@
+#include "MemoryPressureMonitor.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[MemoryPressure] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+
+// Returns -1 for "max" or unreadable files
+int64_t readCgroupValue(const std::string& path) {
+    std::ifstream file(path);
+    std::string value;
+    if (!file || !(file >> value) || value == "max") return -1;
+    try {
+        return std::stoll(value);
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+// Parses "some avg10=1.23 ..." / "full avg10=..." lines of a PSI file
+void readPressure(const std::string& path, double& someAvg10, double& fullAvg10) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find("avg10=");
+        if (pos == std::string::npos) continue;
+        double value = std::atof(line.c_str() + pos + 6);
+        if (line.compare(0, 4, "some") == 0) someAvg10 = value;
+        else if (line.compare(0, 4, "full") == 0) fullAvg10 = value;
+    }
+}
+
+std::string findCgroupDir() {
+    // cgroup v2 unified hierarchy: a single "0::/path" line
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 3, "0::") == 0) {
+            std::string dir = "/sys/fs/cgroup" + line.substr(3);
+            if (access((dir + "/memory.current").c_str(), R_OK) == 0) return dir;
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+MemoryPressureMonitor::MemoryPressureMonitor(ScaleCallback onScaleChanged)
+    : onScaleChanged(std::move(onScaleChanged)) {
+    cgroupDir = findCgroupDir();
+
+    if (!cgroupDir.empty() && access((cgroupDir + "/memory.pressure").c_str(), R_OK) == 0) {
+        pressurePath = cgroupDir + "/memory.pressure";
+    } else if (access("/proc/pressure/memory", R_OK) == 0) {
+        pressurePath = "/proc/pressure/memory";
+    }
+
+    if (cgroupDir.empty() && pressurePath.empty()) {
+        DEBUG_PRINT("No cgroup v2 memory controller or PSI available - adaptive cache disabled");
+        return;
+    }
+
+    // Ask the kernel to wake us when tasks stall >100ms within any 1s window,
+    // so we react before the next poll. Unprivileged processes may not be allowed.
+    if (!pressurePath.empty()) {
+        triggerFd = open(pressurePath.c_str(), O_RDWR | O_NONBLOCK);
+        const char trigger[] = "some 100000 1000000";
+        if (triggerFd >= 0 && write(triggerFd, trigger, strlen(trigger) + 1) < 0) {
+            close(triggerFd);
+            triggerFd = -1;
+        }
+    }
+
+    Sample sample = readSample();
+    DEBUG_PRINT("Monitoring " << (cgroupDir.empty() ? "(no cgroup)" : cgroupDir)
+                << " - memory limit: " << (sample.memoryMax < 0 ? std::string("unlimited")
+                                          : std::to_string(sample.memoryMax / (1024 * 1024)) + " MB")
+                << ", PSI: " << (pressurePath.empty() ? "unavailable" : pressurePath)
+                << (triggerFd >= 0 ? " (trigger armed)" : " (polling)"));
+
+    monitorThread = std::thread(&MemoryPressureMonitor::monitorTask, this);
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() {
+    shouldStop = true;
+    if (monitorThread.joinable()) {
+        monitorThread.join();
+    }
+    if (triggerFd >= 0) {
+        close(triggerFd);
+    }
+}
+
+MemoryPressureMonitor::Sample MemoryPressureMonitor::readSample() const {
+    Sample sample;
+    if (!cgroupDir.empty()) {
+        // memory.high throttles (and then reclaims) before memory.max OOM-kills - use the lower
+        int64_t memoryMax = readCgroupValue(cgroupDir + "/memory.max");
+        int64_t memoryHigh = readCgroupValue(cgroupDir + "/memory.high");
+        sample.memoryMax = (memoryMax > 0 && memoryHigh > 0) ? std::min(memoryMax, memoryHigh)
+                                                             : std::max(memoryMax, memoryHigh);
+        sample.memoryCurrent = readCgroupValue(cgroupDir + "/memory.current");
+    }
+    if (!pressurePath.empty()) {
+        readPressure(pressurePath, sample.someAvg10, sample.fullAvg10);
+    }
+    return sample;
+}
+
+void MemoryPressureMonitor::monitorTask() {
+    // Short poll slices keep shutdown responsive
+    constexpr int SLICE_MS = 100;
+    int waitedMs = 0;
+
+    while (!shouldStop) {
+        bool triggered = false;
+        if (triggerFd >= 0) {
+            struct pollfd pfd = { triggerFd, POLLPRI, 0 };
+            if (poll(&pfd, 1, SLICE_MS) > 0 && (pfd.revents & POLLPRI)) {
+                triggered = true;
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(SLICE_MS));
+        }
+
+        waitedMs += SLICE_MS;
+        if (!triggered && waitedMs < POLL_INTERVAL_MS) continue;
+        waitedMs = 0;
+
+        evaluate(readSample());
+    }
+}
+
+void MemoryPressureMonitor::evaluate(const Sample& sample) {
+    double usage = (sample.memoryMax > 0 && sample.memoryCurrent >= 0)
+                       ? (double)sample.memoryCurrent / (double)sample.memoryMax
+                       : 0.0;
+
+    double current = scale.load(std::memory_order_relaxed);
+    double next = current;
+    std::ostringstream reason;
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (usage > SHRINK_USAGE || sample.someAvg10 > SHRINK_SOME_AVG10 || sample.fullAvg10 > SHRINK_FULL_AVG10) {
+        clearPolls = 0;
+        if (now - lastShrinkTime < SHRINK_COOLDOWN) return;
+        lastShrinkTime = now;
+        next = std::max(MIN_SCALE, current * SHRINK_FACTOR);
+        reason << "pressure";
+    } else if (usage < GROW_USAGE && sample.someAvg10 < GROW_SOME_AVG10) {
+        if (++clearPolls >= CLEAR_POLLS_BEFORE_GROW && current < 1.0) {
+            clearPolls = 0;
+            next = std::min(1.0, current + GROW_STEP);
+            reason << "pressure cleared";
+        }
+    } else {
+        clearPolls = 0;
+    }
+
+    if (next == current) return;
+
+    reason << " (usage " << (int)(usage * 100) << "% of limit, PSI some "
+           << sample.someAvg10 << "% full " << sample.fullAvg10 << "%)";
+    scale.store(next, std::memory_order_relaxed);
+    DEBUG_PRINT("Cache scale " << current << " -> " << next << ": " << reason.str());
+
+    if (onScaleChanged) {
+        onScaleChanged(next, reason.str());
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Watches the cgroup v2 memory limit (memory.max / memory.current) and PSI
+// memory pressure, and turns them into a cache budget scale in
+// [MIN_SCALE, 1.0]: multiplicative decrease under pressure, additive increase
+// once pressure has stayed clear for a while.
+class MemoryPressureMonitor {
+public:
+    // Called on the monitor thread whenever the scale changes
+    using ScaleCallback = std::function<void(double scale, const std::string& reason)>;
+
+    explicit MemoryPressureMonitor(ScaleCallback onScaleChanged);
+    ~MemoryPressureMonitor();
+
+    bool isActive() const { return monitorThread.joinable(); }
+    double getScale() const { return scale.load(std::memory_order_relaxed); }
+
+    static constexpr double MIN_SCALE = 0.2;
+
+private:
+    struct Sample {
+        int64_t memoryMax = -1;      // Lower of memory.max / memory.high, -1 = unlimited
+        int64_t memoryCurrent = -1;
+        double someAvg10 = 0.0;      // % of time some task stalled on memory (10s window)
+        double fullAvg10 = 0.0;      // % of time all tasks stalled
+    };
+
+    // Pressure thresholds (PSI percentages and fraction of memory.max)
+    static constexpr double SHRINK_SOME_AVG10 = 10.0;
+    static constexpr double SHRINK_FULL_AVG10 = 2.0;
+    static constexpr double SHRINK_USAGE = 0.90;
+    static constexpr double GROW_USAGE = 0.75;
+    static constexpr double GROW_SOME_AVG10 = 1.0;
+    static constexpr double SHRINK_FACTOR = 0.75;
+    static constexpr double GROW_STEP = 0.1;
+    static constexpr int CLEAR_POLLS_BEFORE_GROW = 10;
+    static constexpr int POLL_INTERVAL_MS = 1000;
+    // PSI averages lag by up to 10s - give a shrink time to take effect before the next one
+    static constexpr std::chrono::seconds SHRINK_COOLDOWN{3};
+
+    ScaleCallback onScaleChanged;
+    std::atomic<double> scale{1.0};
+    std::atomic<bool> shouldStop{false};
+    std::thread monitorThread;
+
+    std::string cgroupDir;      // e.g. /sys/fs/cgroup/system.slice/consoleVideoPlayer.service
+    std::string pressurePath;   // cgroup memory.pressure, else /proc/pressure/memory
+    int triggerFd = -1;         // PSI trigger (POLLPRI on stall), if the kernel lets us arm one
+    int clearPolls = 0;
+    std::chrono::steady_clock::time_point lastShrinkTime;
+
+    void monitorTask();
+    Sample readSample() const;
+    void evaluate(const Sample& sample);
+};
@@ -0,0 +1,34 @@
+#include "OutputLayout.h"
+
+namespace OutputLayout {
+
+ScaleMode parseScaleMode(const std::string& name) {
+    if (name == "stretch") return ScaleMode::Stretch;
+    if (name == "crop") return ScaleMode::Crop;
+    return ScaleMode::Letterbox;
+}
+
+Quad fit(ScaleMode mode, int outputWidth, int outputHeight, int videoWidth, int videoHeight) {
+    Quad quad;
+    float videoAspect = (float)videoWidth / (float)videoHeight;
+    float outputAspect = (float)outputWidth / (float)outputHeight;
+
+    if (mode == ScaleMode::Stretch) {
+        // Stretch to fill - ignore aspect ratio
+        quad.width = outputWidth;
+        quad.height = outputHeight;
+    } else if ((mode == ScaleMode::Crop) == (outputAspect > videoAspect)) {
+        // Crop with a wider output, or letterbox with a taller one: fit width
+        quad.width = outputWidth;
+        quad.height = outputWidth / videoAspect;
+        quad.y = (outputHeight - quad.height) / 2.0f;
+    } else {
+        // Fit height
+        quad.height = outputHeight;
+        quad.width = outputHeight * videoAspect;
+        quad.x = (outputWidth - quad.width) / 2.0f;
+    }
+    return quad;
+}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+// Where the video lands in the output for a scale mode - shared by the GL
+// and Vulkan presenters.
+namespace OutputLayout {
+
+enum class ScaleMode { Letterbox, Stretch, Crop };
+ScaleMode parseScaleMode(const std::string& name);  // "letterbox" (default), "stretch", "crop"
+
+// Output pixels, top-left origin. May extend past the output for Crop.
+struct Quad {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+Quad fit(ScaleMode mode, int outputWidth, int outputHeight, int videoWidth, int videoHeight);
+
+}
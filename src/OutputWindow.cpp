@@ -0,0 +1,190 @@
+#include "OutputWindow.h"
+#include <cstdio>
+#include <iostream>
+#include "WarpMesh.h"
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[OutputWindow] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+// Another context current for a scope, then back to the one before
+class ContextScope {
+public:
+    ContextScope(SDL_Window* window, SDL_GLContext context)
+        : previousWindow(SDL_GL_GetCurrentWindow()), previousContext(SDL_GL_GetCurrentContext()) {
+        SDL_GL_MakeCurrent(window, context);
+    }
+    ~ContextScope() { SDL_GL_MakeCurrent(previousWindow, previousContext); }
+
+private:
+    SDL_Window* previousWindow;
+    SDL_GLContext previousContext;
+};
+}
+
+OutputWindow::OutputWindow(SDL_Window* window, SDL_GLContext context, GlRenderer* renderer)
+    : window(window), context(context), renderer(renderer) {
+    SDL_GL_GetDrawableSize(window, &width, &height);
+    blendMaskAvailable = blendMask.init();
+}
+
+std::unique_ptr<OutputWindow> OutputWindow::create(int index, GlRenderer::Backend backend, const std::string& title,
+                                                   Uint32 windowFlags, int display) {
+    SDL_Window* firstWindow = SDL_GL_GetCurrentWindow();
+    SDL_GLContext firstContext = SDL_GL_GetCurrentContext();
+
+    int windowWidth = 1280;
+    int windowHeight = 720;
+    SDL_Rect bounds;
+    if ((windowFlags & SDL_WINDOW_FULLSCREEN_DESKTOP) && SDL_GetDisplayBounds(display, &bounds) == 0) {
+        windowWidth = bounds.w;
+        windowHeight = bounds.h;
+    }
+
+    // Same attributes as the first context (still set from its creation), plus sharing
+    GlRenderer::setContextAttributes(backend);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    std::unique_ptr<OutputWindow> output(new OutputWindow());
+    output->index = index;
+    output->owned = true;
+    output->window = SDL_CreateWindow(title.c_str(),
+                                      SDL_WINDOWPOS_CENTERED_DISPLAY(display), SDL_WINDOWPOS_CENTERED_DISPLAY(display),
+                                      windowWidth, windowHeight, windowFlags);
+    if (output->window) {
+        output->context = SDL_GL_CreateContext(output->window);
+    }
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+    if (!output->context) {
+        DEBUG_PRINT("Output " << index << ": no shared context on display " << display << ": " << SDL_GetError());
+        SDL_GL_MakeCurrent(firstWindow, firstContext);
+        return nullptr;  // The destructor drops the window
+    }
+
+    // Its own renderer: vertex arrays and the quad's buffer aren't shared
+    output->ownedRenderer = GlRenderer::create(backend);
+    output->renderer = output->ownedRenderer.get();
+    bool ready = output->renderer->init();
+    if (ready) {
+        // One swap waits for vblank per frame - the first output's - or the
+        // outputs would take turns waiting and divide the frame rate
+        SDL_GL_SetSwapInterval(0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        SDL_GL_GetDrawableSize(output->window, &output->width, &output->height);
+        output->blendMaskAvailable = output->blendMask.init();
+    }
+    SDL_GL_MakeCurrent(firstWindow, firstContext);
+    if (!ready) {
+        DEBUG_PRINT("Output " << index << ": renderer failed to initialise");
+        return nullptr;
+    }
+    DEBUG_PRINT("Output " << index << " on display " << display << " (" << output->width << "x" << output->height << ")");
+    return output;
+}
+
+OutputWindow::~OutputWindow() {
+    if (!owned) return;
+    if (context) {
+        // Its own GL objects go with its context
+        {
+            ContextScope scope(window, context);
+            ownedRenderer.reset();
+        }
+        SDL_GL_DeleteContext(context);
+    }
+    if (window) SDL_DestroyWindow(window);
+}
+
+void OutputWindow::configure(const Settings& settings, int videoWidth, int videoHeight) {
+    ContextScope scope(window, context);
+
+    renderer->setScaleMode(OutputLayout::parseScaleMode(settings.scaleMode));
+
+    float x = 0.0f, y = 0.0f, w = 1.0f, h = 1.0f;
+    if (!settings.crop.empty()) {
+        float cropX, cropY, cropWidth, cropHeight;
+        if (videoWidth > 0 && videoHeight > 0 &&
+            std::sscanf(settings.crop.c_str(), " %f , %f , %f , %f", &cropX, &cropY, &cropWidth, &cropHeight) == 4) {
+            x = cropX / videoWidth;
+            y = cropY / videoHeight;
+            w = cropWidth / videoWidth;
+            h = cropHeight / videoHeight;
+        } else {
+            DEBUG_PRINT("Output " << index << ": bad crop \"" << settings.crop << "\" - expected \"x,y,width,height\"");
+        }
+    }
+    renderer->setSourceRect(x, y, w, h);
+
+    if (settings.warpMesh != warpMeshPath || settings.warpCorners != warpCorners) {
+        warpMeshPath = settings.warpMesh;
+        warpCorners = settings.warpCorners;
+        applyWarp();
+    }
+
+    if (settings.blendMask.empty()) {
+        blendMask.unload();
+    } else if (!blendMaskAvailable) {
+        DEBUG_PRINT("Output " << index << ": blendMask needs GLSL - ignored");
+    } else if (settings.blendMask != blendMask.getPath()) {
+        blendMask.load(settings.blendMask);
+    }
+}
+
+void OutputWindow::applyWarp() {
+    std::error_code ignored;
+    warpMeshWriteTime = std::filesystem::last_write_time(warpMeshPath, ignored);
+
+    std::shared_ptr<WarpMesh> mesh;
+    if (!warpMeshPath.empty()) {
+        mesh = std::make_shared<WarpMesh>();
+        std::string error;
+        if (!WarpMesh::load(warpMeshPath, *mesh, error)) {
+            // Keep the current warp; a file still being written retries at the next change
+            DEBUG_PRINT("Output " << index << ": can't load warpMesh " << warpMeshPath << ": " << error);
+            return;
+        }
+    } else if (!warpCorners.empty()) {
+        float corners[8];
+        if (!WarpMesh::parseCorners(warpCorners, corners)) {
+            DEBUG_PRINT("Output " << index << ": bad warpCorners \"" << warpCorners << "\" - expected \"x,y x,y x,y x,y\"");
+            return;
+        }
+        mesh = std::make_shared<WarpMesh>(WarpMesh::fromCorners(corners));
+    }
+    renderer->setWarpMesh(mesh);
+}
+
+void OutputWindow::reloadIfChanged() {
+    ContextScope scope(window, context);
+    if (!warpMeshPath.empty()) {
+        std::error_code error;
+        auto writeTime = std::filesystem::last_write_time(warpMeshPath, error);
+        if (!error && writeTime != warpMeshWriteTime) applyWarp();
+    }
+    blendMask.reloadIfChanged();
+}
+
+void OutputWindow::handleWindowEvent(const SDL_WindowEvent& event) {
+    // The renderer recomputes its quad at the next frame. The event has the
+    // size in window coordinates; on HiDPI displays the drawable is larger.
+    if (event.event == SDL_WINDOWEVENT_SIZE_CHANGED && event.windowID == SDL_GetWindowID(window)) {
+        SDL_GL_GetDrawableSize(window, &width, &height);
+    }
+}
+
+void OutputWindow::makeCurrent() {
+    SDL_GL_MakeCurrent(window, context);
+}
+
+GlRenderer& OutputWindow::begin(int videoWidth, int videoHeight) {
+    makeCurrent();
+    blendMask.publish();
+    renderer->setLayout(width, height, videoWidth, videoHeight);
+    return *renderer;
+}
+
+void OutputWindow::swap() {
+    SDL_GL_SwapWindow(window);
+}
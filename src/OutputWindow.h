@@ -0,0 +1,72 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <SDL2/SDL.h>
+
+#include "BlendMask.h"
+#include "GlRenderer.h"
+
+// One GL output (window / display) of several fed from the same decode.
+// Every output has its own context sharing the first one's objects, so the
+// frame is uploaded once and each output just draws the shared textures with
+// its own crop, scale mode, warp mesh and blend mask.
+class OutputWindow {
+public:
+    struct Settings {
+        int display = 0;
+        std::string crop;  // "x,y,width,height" in source pixels ("" = whole frame)
+        std::string scaleMode = "letterbox";
+        std::string warpMesh;
+        std::string warpCorners;
+        std::string blendMask;
+    };
+
+    // The first output: window, context and renderer come from the backend
+    // fallback in main and stay owned there
+    OutputWindow(SDL_Window* window, SDL_GLContext context, GlRenderer* renderer);
+
+    // Another output on its own window, its context sharing the current
+    // one's objects. Call with the first output's context current; it is
+    // current again on return. nullptr (logged) on failure.
+    static std::unique_ptr<OutputWindow> create(int index, GlRenderer::Backend backend, const std::string& title,
+                                                Uint32 windowFlags, int display);
+    ~OutputWindow();
+
+    // Scale mode, crop, warp and blend mask (video size: what crop is in).
+    // Files already loaded aren't re-read; a warp or mask that fails to load
+    // keeps the current one.
+    void configure(const Settings& settings, int videoWidth, int videoHeight);
+    // Re-load the warp mesh / blend mask files if they were rewritten
+    void reloadIfChanged();
+
+    void handleWindowEvent(const SDL_WindowEvent& event);
+
+    // Uploads go through the first output's context
+    void makeCurrent();
+    // Make the context current, publish the blend mask and lay out for the
+    // frame size; draw on the returned renderer, then swap()
+    GlRenderer& begin(int videoWidth, int videoHeight);
+    void swap();
+
+private:
+    OutputWindow() = default;
+    void applyWarp();
+
+    int index = 0;
+    SDL_Window* window = nullptr;
+    SDL_GLContext context = nullptr;
+    GlRenderer* renderer = nullptr;
+    bool owned = false;  // Window, context and renderer are ours to destroy
+    std::unique_ptr<GlRenderer> ownedRenderer;
+    int width = 0;
+    int height = 0;
+
+    BlendMask blendMask;
+    bool blendMaskAvailable = false;
+
+    std::string warpMeshPath;
+    std::string warpCorners;
+    std::filesystem::file_time_type warpMeshWriteTime;
+};
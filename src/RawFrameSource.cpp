@@ -0,0 +1,345 @@
+#include "RawFrameSource.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[RawFrameSource] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+// How often the reader checks the ring for a newer frame
+constexpr std::chrono::microseconds RING_POLL{500};
+// How long a blocked pipe read waits before checking for shutdown
+constexpr int PIPE_POLL_MS = 100;
+
+AVPixelFormat parseFormat(const std::string& name) {
+    if (name == "rgb24") return AV_PIX_FMT_RGB24;
+    if (name == "rgba") return AV_PIX_FMT_RGBA;
+    if (name == "yuv420p") return AV_PIX_FMT_YUV420P;
+    if (name == "nv12") return AV_PIX_FMT_NV12;
+    return AV_PIX_FMT_NONE;
+}
+
+AVPixelFormat ringFormat(uint32_t format) {
+    switch (format) {
+        case FrameRing::RGB24: return AV_PIX_FMT_RGB24;
+        case FrameRing::RGBA: return AV_PIX_FMT_RGBA;
+        case FrameRing::YUV420P: return AV_PIX_FMT_YUV420P;
+        case FrameRing::NV12: return AV_PIX_FMT_NV12;
+        default: return AV_PIX_FMT_NONE;
+    }
+}
+
+int packedBytesPerPixel(AVPixelFormat format) {
+    if (format == AV_PIX_FMT_RGB24) return 3;
+    if (format == AV_PIX_FMT_RGBA) return 4;
+    return 0;
+}
+
+bool startsWith(const std::string& text, const char* prefix) {
+    return text.compare(0, std::strlen(prefix), prefix) == 0;
+}
+}
+
+// The mapped ring; unmapped once the reader and every zero-copy frame are done with it
+struct RawFrameSource::Mapping {
+    uint8_t* base = nullptr;
+    size_t size = 0;
+
+    FrameRing::Header* header() const { return reinterpret_cast<FrameRing::Header*>(base); }
+    const uint8_t* slotData(uint32_t slot) const {
+        return base + header()->dataOffset + (size_t)slot * header()->slotBytes;
+    }
+
+    ~Mapping() {
+        if (base) munmap(base, size);
+    }
+};
+
+bool RawFrameSource::isRawUri(const std::string& uri) {
+    return uri == "-" || uri == "stdin" || startsWith(uri, "pipe:") ||
+           startsWith(uri, "shm:") || startsWith(uri, "memfd:");
+}
+
+RawFrameSource::RawFrameSource(const std::string& uri, const Options& options, FrameCallback onFrame)
+    : uri(uri), options(options), onFrame(std::move(onFrame)) {
+}
+
+RawFrameSource::~RawFrameSource() {
+    shouldStop = true;
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+    if (ownsFd && fd >= 0) {
+        close(fd);
+    }
+    sws_freeContext(swsContext);
+}
+
+bool RawFrameSource::start() {
+    bool opened;
+    if (startsWith(uri, "shm:")) {
+        opened = openRing(uri.substr(4), true);
+    } else if (startsWith(uri, "memfd:")) {
+        opened = openRing(uri.substr(6), false);
+    } else {
+        opened = openPipe(startsWith(uri, "pipe:") ? uri.substr(5) : std::string());
+    }
+    if (!opened) return false;
+
+    if (ring) {
+        readerThread = std::thread(&RawFrameSource::ringReaderLoop, this);
+    } else {
+        readerThread = std::thread(&RawFrameSource::pipeReaderLoop, this);
+    }
+    return true;
+}
+
+RawFrameSource::Stats RawFrameSource::getStats() const {
+    Stats stats;
+    stats.framesReceived = framesReceived.load(std::memory_order_relaxed);
+    stats.framesZeroCopy = framesZeroCopy.load(std::memory_order_relaxed);
+    stats.framesSkipped = framesSkipped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool RawFrameSource::openPipe(const std::string& path) {
+    pixelFormat = parseFormat(options.format);
+    if (pixelFormat == AV_PIX_FMT_NONE) {
+        errorMessage = "Unknown raw pixel format " + options.format;
+        return false;
+    }
+    if (options.width <= 0 || options.height <= 0) {
+        errorMessage = "Raw pipe input needs rawWidth and rawHeight";
+        return false;
+    }
+    width = options.width;
+    height = options.height;
+    packedStride = width * packedBytesPerPixel(pixelFormat);
+    frameBytes = (size_t)av_image_get_buffer_size(pixelFormat, width, height, 1);
+
+    if (path.empty()) {
+        fd = STDIN_FILENO;
+        ownsFd = false;
+    } else {
+        // Opening a FIFO read-write never blocks on a missing producer and never
+        // sees EOF when one exits, so producers can come and go
+        struct stat info;
+        bool fifo = stat(path.c_str(), &info) == 0 && S_ISFIFO(info.st_mode);
+        fd = open(path.c_str(), fifo ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            errorMessage = "Cannot open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        ownsFd = true;
+    }
+
+    if (pixelFormat != AV_PIX_FMT_RGB24) {
+        staging.resize(frameBytes);
+    }
+
+    DEBUG_PRINT("Reading " << width << "x" << height << " " << options.format << " frames from "
+                << (path.empty() ? "stdin" : path) << " (" << frameBytes << " bytes each)");
+    return true;
+}
+
+bool RawFrameSource::openRing(const std::string& path, bool posixShm) {
+    int ringFd = posixShm ? shm_open(path.c_str(), O_RDWR, 0) : open(path.c_str(), O_RDWR);
+    if (ringFd < 0) {
+        errorMessage = "Cannot open frame ring " + path + ": " + std::strerror(errno) +
+                       " (the producer must create it first)";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(ringFd, &info) < 0 || (size_t)info.st_size < sizeof(FrameRing::Header)) {
+        close(ringFd);
+        errorMessage = "Frame ring " + path + " is too small for its header";
+        return false;
+    }
+
+    // Read-write: the consumer side of the protocol bumps the readers counts
+    void* base = mmap(nullptr, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, ringFd, 0);
+    close(ringFd);
+    if (base == MAP_FAILED) {
+        errorMessage = "Cannot map frame ring " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    ring = std::make_shared<Mapping>();
+    ring->base = static_cast<uint8_t*>(base);
+    ring->size = (size_t)info.st_size;
+
+    const FrameRing::Header* header = ring->header();
+    pixelFormat = ringFormat(header->format);
+    if (std::memcmp(header->magic, FrameRing::MAGIC, sizeof(FrameRing::MAGIC)) != 0 ||
+        header->version != FrameRing::VERSION) {
+        errorMessage = "Frame ring " + path + " has an unknown layout";
+    } else if (header->slotCount == 0 || header->slotCount > FrameRing::MAX_SLOTS ||
+               header->width == 0 || header->height == 0 || pixelFormat == AV_PIX_FMT_NONE) {
+        errorMessage = "Frame ring " + path + " has an invalid header";
+    }
+    if (!errorMessage.empty()) {
+        ring.reset();
+        return false;
+    }
+
+    width = (int)header->width;
+    height = (int)header->height;
+    int minStride = width * packedBytesPerPixel(pixelFormat);
+    packedStride = (minStride && header->stride) ? std::max((int)header->stride, minStride) : minStride;
+    frameBytes = packedStride ? (size_t)packedStride * height
+                              : (size_t)av_image_get_buffer_size(pixelFormat, width, height, 1);
+
+    if (frameBytes > header->slotBytes ||
+        header->dataOffset + (uint64_t)header->slotCount * header->slotBytes > ring->size) {
+        errorMessage = "Frame ring " + path + " is smaller than its slots";
+        ring.reset();
+        return false;
+    }
+
+    bool zeroCopy = options.latestOnly && pixelFormat == AV_PIX_FMT_RGB24 && packedStride == width * 3;
+    DEBUG_PRINT("Frame ring " << path << ": " << width << "x" << height << ", " << header->slotCount
+                << " slots" << (zeroCopy ? ", zero-copy" : ""));
+    return true;
+}
+
+// Fill dest completely; false at end of stream or shutdown
+bool RawFrameSource::readFully(uint8_t* dest, size_t bytes) {
+    size_t done = 0;
+    while (done < bytes) {
+        if (shouldStop) return false;
+
+        pollfd request = { fd, POLLIN, 0 };
+        int ready = poll(&request, 1, PIPE_POLL_MS);
+        if (ready < 0 && errno != EINTR) return false;
+        if (ready <= 0) continue;
+
+        ssize_t n = read(fd, dest + done, bytes - done);
+        if (n > 0) {
+            done += (size_t)n;
+        } else if (n == 0) {
+            DEBUG_PRINT("End of stream" << (done ? " (partial frame dropped)" : ""));
+            return false;
+        } else if (errno != EINTR && errno != EAGAIN) {
+            DEBUG_PRINT("Read failed: " << std::strerror(errno));
+            return false;
+        }
+    }
+    return true;
+}
+
+void RawFrameSource::pipeReaderLoop() {
+    while (!shouldStop) {
+        if (pixelFormat == AV_PIX_FMT_RGB24) {
+            // Already the cache format - read straight into the frame's own buffer
+            VideoFrame frame;
+            frame.width = width;
+            frame.height = height;
+            frame.linesize = width * 3;
+            frame.data.resize(frameBytes);
+            if (!readFully(frame.data.data(), frameBytes)) break;
+            deliver(std::move(frame));
+        } else {
+            if (!readFully(staging.data(), frameBytes)) break;
+            deliver(convert(staging.data()));
+        }
+    }
+}
+
+void RawFrameSource::ringReaderLoop() {
+    FrameRing::Header* header = ring->header();
+    bool zeroCopy = options.latestOnly && pixelFormat == AV_PIX_FMT_RGB24 && packedStride == width * 3;
+    uint64_t lastSequence = 0;
+
+    while (!shouldStop) {
+        uint64_t latest = header->latest.load();
+        uint64_t sequence = latest >> 8;
+        uint32_t slot = (uint32_t)(latest & 0xff);
+        if (latest == 0 || sequence == lastSequence || slot >= header->slotCount) {
+            std::this_thread::sleep_for(RING_POLL);
+            continue;
+        }
+
+        // Claim the slot, then make sure the producer didn't start rewriting it first
+        FrameRing::Slot* held = &header->slots[slot];
+        held->readers.fetch_add(1);
+        if (held->sequence.load() != sequence) {
+            held->readers.fetch_sub(1);
+            continue;  // Already superseded - go for the newer frame
+        }
+
+        if (lastSequence != 0 && sequence > lastSequence + 2) {
+            framesSkipped.fetch_add((sequence - lastSequence) / 2 - 1, std::memory_order_relaxed);
+        }
+        lastSequence = sequence;
+
+        const uint8_t* pixels = ring->slotData(slot);
+        if (zeroCopy) {
+            VideoFrame frame;
+            frame.width = width;
+            frame.height = height;
+            frame.linesize = packedStride;
+            frame.externalData = pixels;
+            frame.externalSize = frameBytes;
+            std::shared_ptr<Mapping> mapping = ring;
+            frame.externalOwner = std::shared_ptr<const void>(pixels, [mapping, held](const void*) {
+                held->readers.fetch_sub(1);
+            });
+            framesZeroCopy.fetch_add(1, std::memory_order_relaxed);
+            deliver(std::move(frame));
+        } else {
+            VideoFrame frame = convert(pixels);
+            held->readers.fetch_sub(1);
+            deliver(std::move(frame));
+        }
+    }
+}
+
+// Source pixels -> an owned RGB24 frame
+VideoFrame RawFrameSource::convert(const uint8_t* source) {
+    VideoFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.linesize = width * 3;
+    frame.data.resize((size_t)frame.linesize * height);
+
+    if (pixelFormat == AV_PIX_FMT_RGB24) {
+        for (int y = 0; y < height; y++) {
+            std::memcpy(frame.data.data() + (size_t)y * frame.linesize,
+                        source + (size_t)y * packedStride, frame.linesize);
+        }
+        return frame;
+    }
+
+    uint8_t* planes[4] = {};
+    int linesizes[4] = {};
+    if (packedStride) {
+        planes[0] = const_cast<uint8_t*>(source);
+        linesizes[0] = packedStride;
+    } else {
+        av_image_fill_arrays(planes, linesizes, source, pixelFormat, width, height, 1);
+    }
+
+    swsContext = sws_getCachedContext(swsContext, width, height, pixelFormat, width, height, AV_PIX_FMT_RGB24,
+                                      SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!swsContext) return frame;
+
+    uint8_t* dest[1] = { frame.data.data() };
+    int destLinesize[1] = { frame.linesize };
+    sws_scale(swsContext, planes, linesizes, 0, height, dest, destLinesize);
+    return frame;
+}
+
+void RawFrameSource::deliver(VideoFrame&& frame) {
+    framesReceived.fetch_add(1, std::memory_order_relaxed);
+    onFrame(std::move(frame));
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+#include "VideoFrame.h"
+#include "FrameRing.h"
+
+// Uncompressed frames pushed by another process - a generative visuals
+// engine, a capture tool - instead of decoded from a file. Sources:
+//   "-" or "stdin"    raw frames on standard input
+//   "pipe:<path>"     a named pipe (kept open across producer restarts)
+//   "shm:<name>"      a FrameRing in POSIX shared memory (shm_open)
+//   "memfd:<path>"    a FrameRing in a producer's memfd, e.g. /proc/<pid>/fd/<n>
+// Pipes carry back-to-back frames of the configured size and format; rings
+// describe themselves in their header. Each frame goes to the callback as it
+// arrives, on the reader thread. RGB24 pipe frames are read straight into
+// their frame buffer; with latestOnly, RGB24 ring frames aren't copied at all
+// - the VideoFrame points into the ring slot and holds it until released.
+class RawFrameSource {
+public:
+    struct Options {
+        int width = 0;                  // Pipes only - rings carry their own geometry
+        int height = 0;
+        std::string format = "rgb24";   // "rgb24", "rgba", "yuv420p", "nv12"
+        bool latestOnly = false;        // Consumer only wants the newest frame (enables zero-copy)
+    };
+
+    using FrameCallback = std::function<void(VideoFrame&& frame)>;
+
+    static bool isRawUri(const std::string& uri);
+
+    RawFrameSource(const std::string& uri, const Options& options, FrameCallback onFrame);
+    ~RawFrameSource();
+
+    // Opens the source (a ring must already exist) and starts the reader thread
+    bool start();
+    std::string getErrorMessage() const { return errorMessage; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    struct Stats {
+        uint64_t framesReceived = 0;
+        uint64_t framesZeroCopy = 0;   // Handed over without touching the pixels
+        uint64_t framesSkipped = 0;    // Ring frames overwritten before we got to them
+    };
+    Stats getStats() const;
+
+private:
+    struct Mapping;
+
+    std::string uri;
+    Options options;
+    FrameCallback onFrame;
+    std::string errorMessage;
+
+    int width = 0;
+    int height = 0;
+    AVPixelFormat pixelFormat = AV_PIX_FMT_RGB24;
+    size_t frameBytes = 0;
+    int packedStride = 0;  // Row bytes of packed (RGB) formats
+
+    int fd = -1;
+    bool ownsFd = false;
+    std::shared_ptr<Mapping> ring;  // Shared with zero-copy frames still on screen
+
+    std::thread readerThread;
+    std::atomic<bool> shouldStop{false};
+
+    SwsContext* swsContext = nullptr;  // Reader thread only
+    std::vector<uint8_t> staging;      // Pipe frames that need converting
+
+    std::atomic<uint64_t> framesReceived{0};
+    std::atomic<uint64_t> framesZeroCopy{0};
+    std::atomic<uint64_t> framesSkipped{0};
+
+    bool openPipe(const std::string& path);
+    bool openRing(const std::string& path, bool posixShm);
+    void pipeReaderLoop();
+    void ringReaderLoop();
+    bool readFully(uint8_t* dest, size_t bytes);
+    VideoFrame convert(const uint8_t* source);
+    void deliver(VideoFrame&& frame);
+};
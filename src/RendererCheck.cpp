@@ -0,0 +1,304 @@
+#include "RendererCheck.h"
+#include "GlRenderer.h"
+#include "Deinterlacer.h"
+#include "YuvPlaneRenderer.h"
+#include <SDL2/SDL.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int SIZE = 8;  // Source frame and output are SIZE x SIZE (letterbox: twice as wide)
+constexpr int TOLERANCE = 2;
+
+PFNGLGENFRAMEBUFFERSPROC genFramebuffers = nullptr;
+PFNGLBINDFRAMEBUFFERPROC bindFramebuffer = nullptr;
+PFNGLFRAMEBUFFERTEXTURE2DPROC framebufferTexture2D = nullptr;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC checkFramebufferStatus = nullptr;
+PFNGLDELETEFRAMEBUFFERSPROC deleteFramebuffers = nullptr;
+
+// Core name first, then the EXT_framebuffer_object one (same enums) for GL 2.1
+template <typename T>
+bool loadFunction(T& function, const std::string& name) {
+    function = reinterpret_cast<T>(SDL_GL_GetProcAddress(name.c_str()));
+    if (!function) function = reinterpret_cast<T>(SDL_GL_GetProcAddress((name + "EXT").c_str()));
+    return function != nullptr;
+}
+
+bool loadFramebufferFunctions() {
+    return loadFunction(genFramebuffers, "glGenFramebuffers") &&
+           loadFunction(bindFramebuffer, "glBindFramebuffer") &&
+           loadFunction(framebufferTexture2D, "glFramebufferTexture2D") &&
+           loadFunction(checkFramebufferStatus, "glCheckFramebufferStatus") &&
+           loadFunction(deleteFramebuffers, "glDeleteFramebuffers");
+}
+
+// An RGBA texture bound as the draw target
+struct Target {
+    GLuint texture = 0;
+    GLuint framebuffer = 0;
+    int width = 0;
+    int height = 0;
+
+    bool create(int targetWidth, int targetHeight) {
+        release();
+        width = targetWidth;
+        height = targetHeight;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        genFramebuffers(1, &framebuffer);
+        bindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+        return checkFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void release() {
+        if (framebuffer) {
+            bindFramebuffer(GL_FRAMEBUFFER, 0);
+            deleteFramebuffers(1, &framebuffer);
+            framebuffer = 0;
+        }
+        if (texture) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+
+    // RGBA, top row first (GL reads bottom-up)
+    std::vector<uint8_t> read() const {
+        std::vector<uint8_t> bottomUp((size_t)width * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, bottomUp.data());
+        std::vector<uint8_t> pixels(bottomUp.size());
+        size_t rowBytes = (size_t)width * 4;
+        for (int y = 0; y < height; y++) {
+            std::copy_n(bottomUp.data() + (size_t)(height - 1 - y) * rowBytes, rowBytes,
+                        pixels.data() + (size_t)y * rowBytes);
+        }
+        return pixels;
+    }
+};
+
+// Source pattern: red and green follow the row, blue the column
+uint8_t patternRed(int y) { return (uint8_t)(y * 30); }
+uint8_t patternGreen(int y) { return (uint8_t)(255 - y * 30); }
+uint8_t patternBlue(int x) { return (uint8_t)(x * 30); }
+
+GLuint createPatternTexture() {
+    std::vector<uint8_t> pixels(SIZE * SIZE * 3);
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            uint8_t* pixel = pixels.data() + (y * SIZE + x) * 3;
+            pixel[0] = patternRed(y);
+            pixel[1] = patternGreen(y);
+            pixel[2] = patternBlue(x);
+        }
+    }
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, SIZE, SIZE, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    return texture;
+}
+
+bool near(int value, int expected) {
+    return std::abs(value - expected) <= TOLERANCE;
+}
+
+// Empty when the pixel matches, else a description of the mismatch
+std::string comparePixel(const std::vector<uint8_t>& pixels, int width, int x, int y, int red, int green, int blue) {
+    const uint8_t* pixel = pixels.data() + ((size_t)y * width + x) * 4;
+    if (near(pixel[0], red) && near(pixel[1], green) && near(pixel[2], blue)) return "";
+    return "pixel " + std::to_string(x) + "," + std::to_string(y) + " is " +
+           std::to_string(pixel[0]) + " " + std::to_string(pixel[1]) + " " + std::to_string(pixel[2]) +
+           ", expected " + std::to_string(red) + " " + std::to_string(green) + " " + std::to_string(blue);
+}
+
+int report(const char* name, const std::string& error) {
+    if (error.empty()) {
+        std::cout << "  ok    " << name << std::endl;
+        return 0;
+    }
+    std::cout << "  FAIL  " << name << ": " << error << std::endl;
+    return 1;
+}
+
+std::string checkStretch(GlRenderer& renderer, Target& target, GLuint pattern) {
+    renderer.setScaleMode(GlRenderer::ScaleMode::Stretch);
+    renderer.setLayout(SIZE, SIZE, SIZE, SIZE);
+    renderer.clear();
+    renderer.drawTexture(pattern);
+    std::vector<uint8_t> pixels = target.read();
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            std::string error = comparePixel(pixels, SIZE, x, y, patternRed(y), patternGreen(y), patternBlue(x));
+            if (!error.empty()) return error;
+        }
+    }
+    return "";
+}
+
+// Square frame on a 2:1 output: a quarter of the width black on each side
+std::string checkLetterbox(GlRenderer& renderer, GLuint pattern) {
+    Target wide;
+    if (!wide.create(SIZE * 2, SIZE)) return "framebuffer incomplete";
+    renderer.setScaleMode(GlRenderer::ScaleMode::Letterbox);
+    renderer.setLayout(SIZE * 2, SIZE, SIZE, SIZE);
+    renderer.clear();
+    renderer.drawTexture(pattern);
+    std::vector<uint8_t> pixels = wide.read();
+    wide.release();
+    int bar = SIZE / 2;
+    for (int x : {0, bar - 1, bar + SIZE, SIZE * 2 - 1}) {
+        std::string error = comparePixel(pixels, SIZE * 2, x, 0, 0, 0, 0);
+        if (!error.empty()) return error;
+    }
+    return comparePixel(pixels, SIZE * 2, bar + 1, 0, patternRed(0), patternGreen(0), patternBlue(1));
+}
+
+// Top field: even rows as they are, odd rows the average of their neighbours
+std::string checkBob(GlRenderer& renderer, Target& target, GLuint pattern) {
+    Deinterlacer deinterlacer;
+    if (!deinterlacer.init()) return "deinterlacer unavailable";
+    VideoFrame frame;
+    frame.width = SIZE;
+    frame.height = SIZE;
+    frame.linesize = SIZE * 3;
+    renderer.setScaleMode(GlRenderer::ScaleMode::Stretch);
+    renderer.setLayout(SIZE, SIZE, SIZE, SIZE);
+    renderer.clear();
+    deinterlacer.draw(pattern, frame, 0, Deinterlacer::Mode::Bob, renderer);
+    std::vector<uint8_t> pixels = target.read();
+    std::string error = comparePixel(pixels, SIZE, 0, 2, patternRed(2), patternGreen(2), patternBlue(0));
+    if (!error.empty()) return error;
+    return comparePixel(pixels, SIZE, 0, 3, (patternRed(2) + patternRed(4)) / 2,
+                        (patternGreen(2) + patternGreen(4)) / 2, patternBlue(0));
+}
+
+// 10-bit limited range BT.709 greys: 940 = white, 64 = black, 502 = mid grey
+std::string checkLimitedRangeYuv(GlRenderer& renderer, Target& target) {
+    YuvPlaneRenderer yuv;
+    if (!yuv.init()) return "YUV renderer unavailable";
+    VideoFrame frame;
+    frame.width = SIZE;
+    frame.height = SIZE;
+    frame.linesize = SIZE * 2;
+    frame.format = VideoFrame::YUV16;
+    frame.planeCount = 3;
+    frame.sampleScale = 65535.0f / (1023 << 6);
+    frame.bitDepth = 10;
+    frame.colorSpace = 1;  // AVCOL_SPC_BT709
+    frame.fullRange = false;
+    for (int plane = 0; plane < 3; plane++) {
+        frame.planes[plane].offset = (size_t)plane * SIZE * SIZE * 2;
+        frame.planes[plane].linesize = SIZE * 2;
+        frame.planes[plane].width = SIZE;
+        frame.planes[plane].height = SIZE;
+    }
+    renderer.setScaleMode(GlRenderer::ScaleMode::Stretch);
+    renderer.setLayout(SIZE, SIZE, SIZE, SIZE);
+    std::vector<uint16_t> samples(SIZE * SIZE * 3);
+    for (int level : {940, 64, 502}) {
+        for (int i = 0; i < SIZE * SIZE; i++) {
+            samples[i] = (uint16_t)(level << 6);
+            samples[SIZE * SIZE + i] = 512 << 6;
+            samples[SIZE * SIZE * 2 + i] = 512 << 6;
+        }
+        yuv.upload(frame, reinterpret_cast<const uint8_t*>(samples.data()));
+        renderer.clear();
+        yuv.draw(frame, renderer);
+        int grey = (int)((level - 64) * 255.0f / 876.0f + 0.5f);
+        std::string error = comparePixel(target.read(), SIZE, 0, 0, grey, grey, grey);
+        if (!error.empty()) return "level " + std::to_string(level) + ": " + error;
+    }
+    return "";
+}
+
+// The current context's backend; returns the number of failed checks
+int checkBackend(GlRenderer& renderer) {
+    if (!loadFramebufferFunctions()) {
+        std::cout << "  skipped - no framebuffer objects" << std::endl;
+        return 0;
+    }
+    Target target;
+    if (!target.create(SIZE, SIZE)) {
+        std::cout << "  skipped - framebuffer incomplete" << std::endl;
+        target.release();
+        return 0;
+    }
+    GLuint pattern = createPatternTexture();
+
+    int failures = 0;
+    failures += report("stretch", checkStretch(renderer, target, pattern));
+    failures += report("letterbox bars", checkLetterbox(renderer, pattern));
+    target.create(SIZE, SIZE);
+    failures += report("bob deinterlace", checkBob(renderer, target, pattern));
+    if (renderer.has16BitTextures()) {
+        failures += report("limited-range 10-bit YUV", checkLimitedRangeYuv(renderer, target));
+    } else {
+        std::cout << "  -     limited-range 10-bit YUV (no 16-bit textures)" << std::endl;
+    }
+    GLenum glError = glGetError();
+    if (glError != GL_NO_ERROR) {
+        failures += report("GL errors", "error 0x" + std::to_string(glError));
+    }
+
+    glDeleteTextures(1, &pattern);
+    target.release();
+    return failures;
+}
+
+} // namespace
+
+int runRendererCheck() {
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    int checkedBackends = 0;
+    for (GlRenderer::Backend backend : GlRenderer::parseBackends("auto")) {
+        const char* name = GlRenderer::backendName(backend);
+        std::cout << name << ":" << std::endl;
+        GlRenderer::setContextAttributes(backend);
+        SDL_Window* window = SDL_CreateWindow("renderer check", 0, 0, SIZE, SIZE,
+                                              SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+        SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+        if (!context) {
+            std::cout << "  skipped - no context: " << SDL_GetError() << std::endl;
+        } else {
+            std::unique_ptr<GlRenderer> renderer = GlRenderer::create(backend);
+            if (!renderer->init()) {
+                std::cout << "  FAIL  renderer failed to initialise" << std::endl;
+                failures++;
+            } else {
+                failures += checkBackend(*renderer);
+                checkedBackends++;
+            }
+            renderer.reset();
+            SDL_GL_DeleteContext(context);
+        }
+        if (window) SDL_DestroyWindow(window);
+    }
+    SDL_Quit();
+
+    if (checkedBackends == 0) {
+        std::cout << "No GL backend could be checked" << std::endl;
+        return 1;
+    }
+    std::cout << (failures ? std::to_string(failures) + " check(s) failed" : "All checks passed") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// Draws known frames with each GL renderer backend (legacy, core, gles2)
+// into an offscreen framebuffer and compares the pixels read back: plain
+// stretch, letterbox bars, bob deinterlacing and, where 16-bit textures
+// exist, limited-range 10-bit YUV. Backends without a context are skipped.
+// Returns non-zero if any check failed.
+// Run with: consoleVideoPlayer --check-renderer
+// (headless, e.g. Mesa llvmpipe: SDL_VIDEODRIVER=offscreen)
+int runRendererCheck();
@@ -0,0 +1,86 @@
+#include "ScalerBenchmark.h"
+#include "DecodePool.h"
+#include "SoftwareScaler.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+constexpr double SECONDS_PER_CASE = 2.0;
+
+struct Case {
+    const char* name;
+    int width;
+    int height;
+    OutputLayout::ScaleMode mode;
+};
+
+VideoFrame makeFrame(int width, int height) {
+    VideoFrame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.linesize = width * 3;
+    frame.data.resize((size_t)frame.linesize * height);
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = frame.data.data() + (size_t)y * frame.linesize;
+        for (int x = 0; x < width; x++) {
+            row[x * 3] = (uint8_t)x;
+            row[x * 3 + 1] = (uint8_t)y;
+            row[x * 3 + 2] = (uint8_t)(x ^ y);
+        }
+    }
+    return frame;
+}
+
+double framesPerSecond(SoftwareScaler& scaler, const VideoFrame& frame, std::vector<uint8_t>& output,
+                       int outputWidth, int outputHeight, OutputLayout::ScaleMode mode) {
+    scaler.scale(frame, output.data(), outputWidth * 4, outputWidth, outputHeight, mode);  // Warm up
+    int frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    while (seconds < SECONDS_PER_CASE) {
+        scaler.scale(frame, output.data(), outputWidth * 4, outputWidth, outputHeight, mode);
+        frames++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return frames / seconds;
+}
+
+} // namespace
+
+int runScalerBenchmark(int outputWidth, int outputHeight) {
+    if (outputWidth < 2 || outputHeight < 2) {
+        std::cerr << "Invalid output size" << std::endl;
+        return 1;
+    }
+
+    std::vector<Case> cases = {
+        { "1920x1080 letterbox", 1920, 1080, OutputLayout::ScaleMode::Letterbox },
+        { "1280x720 letterbox",  1280,  720, OutputLayout::ScaleMode::Letterbox },
+        { "3840x2160 letterbox", 3840, 2160, OutputLayout::ScaleMode::Letterbox },
+        { "1440x1080 letterbox", 1440, 1080, OutputLayout::ScaleMode::Letterbox },
+        { "1440x1080 stretch",   1440, 1080, OutputLayout::ScaleMode::Stretch },
+        { "2048x858 crop",       2048,  858, OutputLayout::ScaleMode::Crop },
+    };
+
+    std::vector<uint8_t> output((size_t)outputWidth * outputHeight * 4);
+    SoftwareScaler single;
+    single.setThreaded(false);
+    SoftwareScaler pooled;
+
+    std::cout << "Software scaler benchmark: " << outputWidth << "x" << outputHeight << " output, "
+              << DecodePool::instance().getThreadCount() << " pool workers" << std::endl;
+    std::cout << std::left << std::setw(22) << "source" << std::right
+              << std::setw(14) << "1 thread fps" << std::setw(12) << "pool fps" << std::endl;
+
+    for (const Case& c : cases) {
+        VideoFrame frame = makeFrame(c.width, c.height);
+        double singleFps = framesPerSecond(single, frame, output, outputWidth, outputHeight, c.mode);
+        double pooledFps = framesPerSecond(pooled, frame, output, outputWidth, outputHeight, c.mode);
+        std::cout << std::left << std::setw(22) << c.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << singleFps << std::setw(12) << pooledFps << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Scales synthetic RGB24 frames (same size, upscale, downscale, letterbox,
+// crop) into an outputWidth x outputHeight XRGB buffer with the software
+// presenter's scaler, on one thread and on the decode pool, and prints the
+// sustained frames per second for each - the CPU-only ceiling of
+// "renderer": "software" before SDL's copy to the window.
+// Run with: consoleVideoPlayer --bench-software [WIDTHxHEIGHT]
+int runScalerBenchmark(int outputWidth, int outputHeight);
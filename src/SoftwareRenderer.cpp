@@ -0,0 +1,105 @@
+#include "SoftwareRenderer.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[SoftwareRenderer] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+SoftwareRenderer::~SoftwareRenderer() {
+    if (texture) SDL_DestroyTexture(texture);
+    if (sdlRenderer) SDL_DestroyRenderer(sdlRenderer);
+}
+
+bool SoftwareRenderer::init(SDL_Window* sdlWindow) {
+    window = sdlWindow;
+
+    // Keep SDL from putting GL back underneath, for the renderer or the window surface
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    SDL_SetHint(SDL_HINT_FRAMEBUFFER_ACCELERATION, "0");
+
+    sdlRenderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE | SDL_RENDERER_PRESENTVSYNC);
+    if (!sdlRenderer) {
+        sdlRenderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    }
+    if (!sdlRenderer) {
+        DEBUG_PRINT("Software renderer creation failed: " << SDL_GetError());
+        return false;
+    }
+
+    SDL_RendererInfo info;
+    vsync = SDL_GetRendererInfo(sdlRenderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    SDL_DisplayMode mode;
+    int refreshRate = (SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) ? mode.refresh_rate : 60;
+    refreshInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / refreshRate));
+    nextPresent = std::chrono::steady_clock::now();
+
+    DEBUG_PRINT("Software presentation, " << (vsync ? "vsync" : "paced to " + std::to_string(refreshRate) + " Hz"));
+    return true;
+}
+
+void SoftwareRenderer::setScaleMode(OutputLayout::ScaleMode mode) {
+    scaleMode = mode;
+    shownBufferId = 0;
+}
+
+void SoftwareRenderer::present(const VideoFrame& frame) {
+    int outputWidth = 0;
+    int outputHeight = 0;
+    SDL_GetRendererOutputSize(sdlRenderer, &outputWidth, &outputHeight);
+    if (outputWidth <= 0 || outputHeight <= 0) return;
+
+    // Window-sized texture: the scaler does all the scaling, SDL's copy is 1:1
+    if (outputWidth != textureWidth || outputHeight != textureHeight) {
+        if (texture) SDL_DestroyTexture(texture);
+        texture = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING,
+                                    outputWidth, outputHeight);
+        if (!texture) {
+            DEBUG_PRINT("Texture creation failed: " << SDL_GetError());
+            textureWidth = textureHeight = 0;
+            return;
+        }
+        textureWidth = outputWidth;
+        textureHeight = outputHeight;
+        shownBufferId = 0;
+    }
+
+    // An unchanged frame stays on the texture as it is
+    if (frame.bufferId == 0 || frame.bufferId != shownBufferId ||
+        frame.width != shownWidth || frame.height != shownHeight) {
+        void* pixels = nullptr;
+        int pitch = 0;
+        if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) != 0) {
+            DEBUG_PRINT("Texture lock failed: " << SDL_GetError());
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        scaler.scale(frame, (uint8_t*)pixels, pitch, textureWidth, textureHeight, scaleMode);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        SDL_UnlockTexture(texture);
+
+        shownBufferId = frame.bufferId;
+        shownWidth = frame.width;
+        shownHeight = frame.height;
+        stats.framesScaled++;
+        totalScaleMs += ms;
+        stats.avgScaleMs = totalScaleMs / stats.framesScaled;
+        stats.maxScaleMs = std::max(stats.maxScaleMs, ms);
+    }
+
+    SDL_RenderCopy(sdlRenderer, texture, nullptr, nullptr);
+
+    if (!vsync) {
+        // Fell more than a refresh behind: restart the cadence rather than rush to catch up
+        auto now = std::chrono::steady_clock::now();
+        if (now - nextPresent > refreshInterval) nextPresent = now;
+        std::this_thread::sleep_until(nextPresent);
+        nextPresent += refreshInterval;
+    }
+    SDL_RenderPresent(sdlRenderer);
+    stats.framesPresented++;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <SDL2/SDL.h>
+
+#include "OutputLayout.h"
+#include "SoftwareScaler.h"
+#include "VideoFrame.h"
+
+// Presentation without GL ("renderer": "software", and the last resort when
+// every GL backend fails): frames are scaled on the CPU into a window-sized
+// SDL streaming texture on SDL's software renderer, which SDL copies to the
+// window surface. The scale only runs when the frame or window changes.
+// RGB24 only - high-bit-depth sources are converted on decode and
+// interlaced ones are shown woven.
+class SoftwareRenderer {
+public:
+    SoftwareRenderer() = default;
+    ~SoftwareRenderer();
+
+    // window must not be an SDL_WINDOW_OPENGL one. False (logged) on failure.
+    bool init(SDL_Window* window);
+
+    void setScaleMode(OutputLayout::ScaleMode mode);
+
+    // Scale the frame (unless it's already on the texture) and present it,
+    // paced to the display's refresh rate
+    void present(const VideoFrame& frame);
+
+    struct Stats {
+        uint64_t framesPresented = 0;
+        uint64_t framesScaled = 0;
+        double avgScaleMs = 0.0;
+        double maxScaleMs = 0.0;
+    };
+    Stats getStats() const { return stats; }
+
+private:
+    SDL_Window* window = nullptr;
+    SDL_Renderer* sdlRenderer = nullptr;
+    SDL_Texture* texture = nullptr;
+    int textureWidth = 0;
+    int textureHeight = 0;
+    SoftwareScaler scaler;
+    OutputLayout::ScaleMode scaleMode = OutputLayout::ScaleMode::Letterbox;
+
+    // What the texture holds (bufferId 0 = nothing)
+    uint64_t shownBufferId = 0;
+    int shownWidth = 0;
+    int shownHeight = 0;
+
+    // The software renderer has no vsync - present() sleeps to the refresh instead
+    bool vsync = false;
+    std::chrono::steady_clock::duration refreshInterval{};
+    std::chrono::steady_clock::time_point nextPresent;
+
+    Stats stats;
+    double totalScaleMs = 0.0;
+};
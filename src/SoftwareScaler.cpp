@@ -0,0 +1,257 @@
+#include "SoftwareScaler.h"
+#include "DecodePool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Below this a band isn't worth a pool job
+constexpr int MIN_BAND_ROWS = 32;
+
+// One scale() call, shared with the pool jobs working on it. A job that
+// starts after every band is taken touches nothing but the counters.
+struct Pass {
+    const uint8_t* source = nullptr;
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    int sourceStride = 0;
+    uint8_t* output = nullptr;
+    int outputPitch = 0;
+    int outputWidth = 0;
+    int x0 = 0, x1 = 0;  // Output columns/rows the video covers (clipped)
+    int y0 = 0, y1 = 0;
+    float quadY = 0.0f;
+    float rowScale = 1.0f;  // Source rows per output row
+    bool identity = false;  // 1:1 - swizzle only
+    const int32_t* columnIndex = nullptr;
+    const uint16_t* columnWeight = nullptr;
+
+    int bandCount = 1;
+    int bandRows = 0;
+    std::atomic<int> nextBand{0};
+    std::atomic<int> bandsDone{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+// Horizontal pass: one source row to count B, G, R, 255 texels in 16-bit lanes
+void scaleRow(const uint8_t* row, const int32_t* index, const uint16_t* weight, int count, uint16_t* out) {
+    for (int i = 0; i < count; i++) {
+        const uint8_t* p = row + index[i] * 3;
+        int right = weight[i];
+        int left = 256 - right;
+        out[0] = (uint16_t)((p[2] * left + p[5] * right) >> 8);
+        out[1] = (uint16_t)((p[1] * left + p[4] * right) >> 8);
+        out[2] = (uint16_t)((p[0] * left + p[3] * right) >> 8);
+        out[3] = 255;
+        out += 4;
+    }
+}
+
+// Vertical pass: out = (above * (256 - weight) + below * weight) >> 8. Every
+// term fits 16 bits (255 * 256), so plain 16-bit multiplies do.
+void blendRows(const uint16_t* above, const uint16_t* below, int weight, uint8_t* out, int count) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i weightAbove = _mm_set1_epi16((short)(256 - weight));
+    __m128i weightBelow = _mm_set1_epi16((short)weight);
+    for (; i + 16 <= count; i += 16) {
+        __m128i low = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_loadu_si128((const __m128i*)(above + i)), weightAbove),
+            _mm_mullo_epi16(_mm_loadu_si128((const __m128i*)(below + i)), weightBelow));
+        __m128i high = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_loadu_si128((const __m128i*)(above + i + 8)), weightAbove),
+            _mm_mullo_epi16(_mm_loadu_si128((const __m128i*)(below + i + 8)), weightBelow));
+        _mm_storeu_si128((__m128i*)(out + i),
+                         _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8)));
+    }
+#elif defined(__ARM_NEON)
+    uint16x8_t weightAbove = vdupq_n_u16((uint16_t)(256 - weight));
+    uint16x8_t weightBelow = vdupq_n_u16((uint16_t)weight);
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t sum = vmlaq_u16(vmulq_u16(vld1q_u16(above + i), weightAbove), vld1q_u16(below + i), weightBelow);
+        vst1_u8(out + i, vshrn_n_u16(sum, 8));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = (uint8_t)((above[i] * (256 - weight) + below[i] * weight) >> 8);
+    }
+}
+
+// Source row above output row y and the weight of the one below (0..256)
+void sourceRow(const Pass& pass, int y, int& row, int& weight) {
+    float sy = ((float)y + 0.5f - pass.quadY) * pass.rowScale - 0.5f;
+    sy = std::min(std::max(sy, 0.0f), (float)(pass.sourceHeight - 1));
+    row = std::min((int)sy, pass.sourceHeight - 2);
+    weight = (int)std::lround((sy - row) * 256.0f);
+}
+
+void runBand(const Pass& pass, int band) {
+    int bandStart = band * pass.bandRows;
+    int bandEnd = std::min(bandStart + pass.bandRows, pass.y1 - pass.y0);
+    int columns = pass.x1 - pass.x0;
+
+    // The two source rows in use, scaled horizontally - output rows between
+    // the same pair of source rows (upscaling) reuse them
+    thread_local std::vector<uint16_t> scaled[2];
+    int scaledRow[2] = {-1, -1};
+    if (!pass.identity) {
+        for (auto& buffer : scaled) {
+            if (buffer.size() < (size_t)columns * 4) buffer.resize((size_t)columns * 4);
+        }
+    }
+
+    for (int i = bandStart; i < bandEnd; i++) {
+        int y = pass.y0 + i;
+        uint8_t* out = pass.output + (size_t)y * pass.outputPitch;
+
+        // Pillarbox bars
+        memset(out, 0, (size_t)pass.x0 * 4);
+        memset(out + (size_t)pass.x1 * 4, 0, (size_t)(pass.outputWidth - pass.x1) * 4);
+        out += (size_t)pass.x0 * 4;
+
+        if (pass.identity) {
+            const uint8_t* in = pass.source + (size_t)i * pass.sourceStride;
+            for (int x = 0; x < columns; x++) {
+                out[0] = in[2];
+                out[1] = in[1];
+                out[2] = in[0];
+                out[3] = 255;
+                out += 4;
+                in += 3;
+            }
+            continue;
+        }
+
+        int row, weight;
+        sourceRow(pass, y, row, weight);
+        if (scaledRow[0] != row) {
+            if (scaledRow[1] == row) {
+                std::swap(scaled[0], scaled[1]);
+                scaledRow[0] = row;
+                scaledRow[1] = -1;
+            } else {
+                scaleRow(pass.source + (size_t)row * pass.sourceStride, pass.columnIndex, pass.columnWeight,
+                         columns, scaled[0].data());
+                scaledRow[0] = row;
+            }
+        }
+        if (scaledRow[1] != row + 1) {
+            scaleRow(pass.source + (size_t)(row + 1) * pass.sourceStride, pass.columnIndex, pass.columnWeight,
+                     columns, scaled[1].data());
+            scaledRow[1] = row + 1;
+        }
+        blendRows(scaled[0].data(), scaled[1].data(), weight, out, columns * 4);
+    }
+}
+
+void runBands(Pass& pass) {
+    int band;
+    while ((band = pass.nextBand.fetch_add(1)) < pass.bandCount) {
+        runBand(pass, band);
+        if (pass.bandsDone.fetch_add(1) + 1 == pass.bandCount) {
+            std::lock_guard<std::mutex> lock(pass.mutex);
+            pass.finished.notify_all();
+        }
+    }
+}
+
+}
+
+SoftwareScaler::~SoftwareScaler() {
+    if (poolUsed) {
+        DecodePool::instance().removeOwner(this);
+    }
+}
+
+void SoftwareScaler::scale(const VideoFrame& frame, uint8_t* output, int outputPitch,
+                           int outputWidth, int outputHeight, OutputLayout::ScaleMode mode) {
+    if (frame.format != VideoFrame::RGB24 || frame.width < 2 || frame.height < 2) {
+        for (int y = 0; y < outputHeight; y++) {
+            memset(output + (size_t)y * outputPitch, 0, (size_t)outputWidth * 4);
+        }
+        return;
+    }
+
+    OutputLayout::Quad quad = OutputLayout::fit(mode, outputWidth, outputHeight, frame.width, frame.height);
+
+    auto pass = std::make_shared<Pass>();
+    pass->source = frame.pixels();
+    pass->sourceWidth = frame.width;
+    pass->sourceHeight = frame.height;
+    pass->sourceStride = frame.linesize;
+    pass->output = output;
+    pass->outputPitch = outputPitch;
+    pass->outputWidth = outputWidth;
+    pass->x0 = std::min(std::max((int)std::lround(quad.x), 0), outputWidth);
+    pass->x1 = std::min(std::max((int)std::lround(quad.x + quad.width), 0), outputWidth);
+    pass->y0 = std::min(std::max((int)std::lround(quad.y), 0), outputHeight);
+    pass->y1 = std::min(std::max((int)std::lround(quad.y + quad.height), 0), outputHeight);
+    pass->quadY = quad.y;
+    pass->rowScale = frame.height / quad.height;
+    pass->identity = std::fabs(quad.width - frame.width) < 0.01f && std::fabs(quad.height - frame.height) < 0.01f &&
+                     pass->x1 - pass->x0 == frame.width && pass->y1 - pass->y0 == frame.height;
+
+    if (!pass->identity) {
+        // Source column left of each output column's centre
+        if (columns.sourceWidth != frame.width || columns.x0 != pass->x0 || columns.x1 != pass->x1 ||
+            columns.quadX != quad.x || columns.quadWidth != quad.width) {
+            columns.sourceWidth = frame.width;
+            columns.x0 = pass->x0;
+            columns.x1 = pass->x1;
+            columns.quadX = quad.x;
+            columns.quadWidth = quad.width;
+            columns.index.resize(pass->x1 - pass->x0);
+            columns.weight.resize(pass->x1 - pass->x0);
+            float columnScale = frame.width / quad.width;
+            for (int x = pass->x0; x < pass->x1; x++) {
+                float sx = ((float)x + 0.5f - quad.x) * columnScale - 0.5f;
+                sx = std::min(std::max(sx, 0.0f), (float)(frame.width - 1));
+                int column = std::min((int)sx, frame.width - 2);
+                columns.index[x - pass->x0] = column;
+                columns.weight[x - pass->x0] = (uint16_t)std::lround((sx - column) * 256.0f);
+            }
+        }
+        pass->columnIndex = columns.index.data();
+        pass->columnWeight = columns.weight.data();
+    }
+
+    // Letterbox bars
+    for (int y = 0; y < pass->y0; y++) {
+        memset(output + (size_t)y * outputPitch, 0, (size_t)outputWidth * 4);
+    }
+    for (int y = pass->y1; y < outputHeight; y++) {
+        memset(output + (size_t)y * outputPitch, 0, (size_t)outputWidth * 4);
+    }
+
+    int rows = pass->y1 - pass->y0;
+    if (rows <= 0 || pass->x1 <= pass->x0) return;
+
+    int bands = 1;
+    if (threaded) {
+        bands = std::min(DecodePool::instance().getThreadCount() + 1, std::max(1, rows / MIN_BAND_ROWS));
+    }
+    pass->bandCount = bands;
+    pass->bandRows = (rows + bands - 1) / bands;
+
+    // Due now: ahead of any decode job that isn't already late
+    for (int i = 1; i < bands; i++) {
+        DecodePool::instance().submit(this, DecodePool::Clock::now(), [pass]() { runBands(*pass); });
+        poolUsed = true;
+    }
+    runBands(*pass);
+
+    std::unique_lock<std::mutex> lock(pass->mutex);
+    pass->finished.wait(lock, [&] { return pass->bandsDone.load() == pass->bandCount; });
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "OutputLayout.h"
+#include "VideoFrame.h"
+
+// CPU scaler for the software presenter: an RGB24 frame into a 32-bit XRGB
+// output (bytes B, G, R, 255 - SDL_PIXELFORMAT_RGB888 on little endian) with
+// the scale mode applied and the bars filled black. Bilinear in two passes:
+// each band scales the source rows it needs horizontally once into 16-bit
+// rows, then blends row pairs vertically with SSE2/NEON. A 1:1 fit is a
+// straight channel swizzle. Bands run on the decode pool ahead of decode
+// work, with the calling thread taking bands too.
+class SoftwareScaler {
+public:
+    SoftwareScaler() = default;
+    ~SoftwareScaler();
+
+    // Off: everything on the calling thread (benchmark baseline)
+    void setThreaded(bool enabled) { threaded = enabled; }
+
+    // Blocks until the whole output is written
+    void scale(const VideoFrame& frame, uint8_t* output, int outputPitch,
+               int outputWidth, int outputHeight, OutputLayout::ScaleMode mode);
+
+private:
+    bool threaded = true;
+    bool poolUsed = false;
+
+    // Per output column of the video area: left source pixel and the weight of
+    // the right one (0..256). Rebuilt when the horizontal geometry changes.
+    struct Columns {
+        int sourceWidth = 0;
+        int x0 = 0;
+        int x1 = 0;
+        float quadX = 0.0f;
+        float quadWidth = 0.0f;
+        std::vector<int32_t> index;
+        std::vector<uint16_t> weight;
+    };
+    Columns columns;
+};
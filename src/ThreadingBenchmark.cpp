@@ -0,0 +1,167 @@
+#include "ThreadingBenchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+namespace {
+
+constexpr int LOCATE_SAMPLES = 20;
+constexpr int THROUGHPUT_FRAMES = 300;
+
+struct Mode {
+    const char* name;
+    int threadType;
+    int threadCount;
+};
+
+struct Result {
+    double locateAvgMs = 0.0;
+    double locateMaxMs = 0.0;
+    double framesPerSecond = 0.0;
+    bool ok = false;
+};
+
+// Decode from the current demuxer position until a frame at or after
+// targetPts comes out (or, with targetPts = AV_NOPTS_VALUE, count frames).
+// Returns the number of frames received.
+int decodeUntil(AVFormatContext* format, AVCodecContext* codec, int streamIndex,
+                int64_t targetPts, int maxFrames, AVPacket* packet, AVFrame* frame) {
+    int received = 0;
+    bool reached = false;
+    auto drain = [&]() {
+        while (!reached && avcodec_receive_frame(codec, frame) >= 0) {
+            received++;
+            if (targetPts != AV_NOPTS_VALUE && frame->best_effort_timestamp >= targetPts) reached = true;
+            if (received >= maxFrames) reached = true;
+        }
+    };
+    while (!reached && av_read_frame(format, packet) >= 0) {
+        if (packet->stream_index == streamIndex && avcodec_send_packet(codec, packet) >= 0) {
+            drain();
+        }
+        av_packet_unref(packet);
+    }
+    if (!reached && avcodec_send_packet(codec, nullptr) >= 0) {
+        drain();
+    }
+    return received;
+}
+
+Result benchmarkMode(const std::string& videoPath, const Mode& mode) {
+    Result result;
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, videoPath.c_str(), nullptr, nullptr) < 0) return result;
+    if (avformat_find_stream_info(format, nullptr) < 0) {
+        avformat_close_input(&format);
+        return result;
+    }
+
+    int streamIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIndex < 0) {
+        avformat_close_input(&format);
+        return result;
+    }
+    AVStream* stream = format->streams[streamIndex];
+
+    const AVCodec* decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext* codec = decoder ? avcodec_alloc_context3(decoder) : nullptr;
+    if (!codec || avcodec_parameters_to_context(codec, stream->codecpar) < 0) {
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+        return result;
+    }
+    codec->thread_type = mode.threadType;
+    codec->thread_count = mode.threadCount;
+    if (avcodec_open2(codec, decoder, nullptr) < 0) {
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+        return result;
+    }
+
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+
+    double duration = (double)format->duration / AV_TIME_BASE;
+    int64_t startPts = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+    double timeBase = av_q2d(stream->time_base);
+
+    // Locate: same pseudo-random targets for every mode
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<double> position(0.05, 0.95);
+    double totalMs = 0.0;
+    for (int i = 0; i < LOCATE_SAMPLES; i++) {
+        double seconds = position(random) * duration;
+        int64_t targetPts = startPts + (int64_t)(seconds / timeBase);
+
+        auto start = std::chrono::steady_clock::now();
+        av_seek_frame(format, -1, (int64_t)(seconds * AV_TIME_BASE), AVSEEK_FLAG_BACKWARD);
+        avcodec_flush_buffers(codec);
+        decodeUntil(format, codec, streamIndex, targetPts, 100000, packet, frame);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        totalMs += ms;
+        result.locateMaxMs = std::max(result.locateMaxMs, ms);
+    }
+    result.locateAvgMs = totalMs / LOCATE_SAMPLES;
+
+    // Throughput: sequential decode from the start
+    av_seek_frame(format, -1, 0, AVSEEK_FLAG_BACKWARD);
+    avcodec_flush_buffers(codec);
+    auto start = std::chrono::steady_clock::now();
+    int frames = decodeUntil(format, codec, streamIndex, AV_NOPTS_VALUE, THROUGHPUT_FRAMES, packet, frame);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.framesPerSecond = (seconds > 0.0) ? frames / seconds : 0.0;
+    result.ok = frames > 0;
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&codec);
+    avformat_close_input(&format);
+    return result;
+}
+
+} // namespace
+
+int runThreadingBenchmark(const std::string& videoPath) {
+    int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Mode> modes = {
+        { "single",      FF_THREAD_SLICE,                   1 },
+        { "slice",       FF_THREAD_SLICE,                   cores },
+        { "slice (2)",   FF_THREAD_SLICE,                   2 },
+        { "frame",       FF_THREAD_FRAME,                   cores },
+        { "frame+slice", FF_THREAD_FRAME | FF_THREAD_SLICE, cores },
+    };
+
+    std::cout << "Codec threading benchmark: " << videoPath << " (" << cores << " cores, "
+              << LOCATE_SAMPLES << " locates, " << THROUGHPUT_FRAMES << " sequential frames)" << std::endl;
+    std::cout << std::left << std::setw(14) << "mode" << std::right
+              << std::setw(10) << "threads" << std::setw(16) << "locate avg ms"
+              << std::setw(16) << "locate max ms" << std::setw(12) << "frames/s" << std::endl;
+
+    bool anyOk = false;
+    for (const Mode& mode : modes) {
+        Result result = benchmarkMode(videoPath, mode);
+        if (!result.ok) {
+            std::cout << std::left << std::setw(14) << mode.name << " failed to decode" << std::endl;
+            continue;
+        }
+        anyOk = true;
+        std::cout << std::left << std::setw(14) << mode.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << mode.threadCount << std::setw(16) << result.locateAvgMs
+                  << std::setw(16) << result.locateMaxMs << std::setw(12) << result.framesPerSecond << std::endl;
+    }
+
+    std::cout << "Seek role wants the lowest locate latency, playback role the highest frames/s "
+                 "(see seekThreading / playbackThreading in the config)" << std::endl;
+    return anyOk ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <string>
+
+// Decodes videoPath with each codec threading mode (frame, slice, both,
+// single) and prints locate latency (seek to a random frame until it is
+// decoded) and sustained sequential throughput for each.
+// Run with: consoleVideoPlayer --bench-threading <video>
+int runThreadingBenchmark(const std::string& videoPath);
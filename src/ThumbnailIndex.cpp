@@ -0,0 +1,310 @@
+#include "ThumbnailIndex.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[ThumbnailIndex] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+const char CACHE_MAGIC[8] = {'C', 'V', 'P', 'T', 'H', 'M', 'B', '1'};
+}
+
+ThumbnailIndex::ThumbnailIndex(const std::string& videoPath, int streamIndex, double fps, int totalFrames,
+                               const Options& options)
+    : videoPath(videoPath), streamIndex(streamIndex), fps(fps), totalFrames(totalFrames), options(options) {
+    intervalFrames = (int)std::lround(options.intervalSeconds * fps);
+    builderThread = std::thread(&ThumbnailIndex::buildTask, this);
+}
+
+ThumbnailIndex::~ThumbnailIndex() {
+    shouldStop = true;
+    if (builderThread.joinable()) {
+        builderThread.join();
+    }
+}
+
+std::shared_ptr<const VideoFrame> ThumbnailIndex::nearest(int frameIndex) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (thumbnails.empty()) return nullptr;
+
+    auto after = thumbnails.lower_bound(frameIndex);
+    if (after == thumbnails.begin()) return after->second;
+    auto before = std::prev(after);
+    if (after == thumbnails.end()) return before->second;
+
+    return (frameIndex - before->first <= after->first - frameIndex) ? before->second : after->second;
+}
+
+size_t ThumbnailIndex::getCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return thumbnails.size();
+}
+
+void ThumbnailIndex::addThumbnail(int frameIndex, VideoFrame&& thumbnail) {
+    thumbnail.bufferId = VideoFrame::allocateBufferId();
+    size_t bytes = thumbnail.data.size();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (thumbnails.count(frameIndex)) return;
+    thumbnails[frameIndex] = std::make_shared<const VideoFrame>(std::move(thumbnail));
+    usedBytes += bytes;
+
+    while (usedBytes > options.budgetBytes && thumbnails.size() > 1) {
+        thinOut();
+    }
+}
+
+// Over budget: drop every other thumbnail and keep future ones twice as far apart
+void ThumbnailIndex::thinOut() {
+    int span = thumbnails.rbegin()->first - thumbnails.begin()->first;
+    int averageGap = std::max(1, span / (int)std::max<size_t>(1, thumbnails.size() - 1));
+    intervalFrames = std::max(intervalFrames, averageGap) * 2;
+
+    bool keep = true;
+    for (auto it = thumbnails.begin(); it != thumbnails.end();) {
+        if (keep) {
+            ++it;
+        } else {
+            usedBytes -= it->second->data.size();
+            it = thumbnails.erase(it);
+        }
+        keep = !keep;
+    }
+    DEBUG_PRINT("Budget reached - thinned to " << thumbnails.size() << " thumbnails, one per "
+                << intervalFrames << " frames");
+}
+
+void ThumbnailIndex::buildTask() {
+#ifdef __linux__
+    // Background work - let playback decode win any contention for the CPU
+    setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 10);
+#endif
+
+    if (!options.cachePath.empty() && loadCache()) {
+        complete = true;
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, videoPath.c_str(), nullptr, nullptr) < 0) {
+        DEBUG_PRINT("Failed to open " << videoPath);
+        return;
+    }
+    if (avformat_find_stream_info(formatContext, nullptr) < 0 ||
+        streamIndex >= (int)formatContext->nb_streams) {
+        avformat_close_input(&formatContext);
+        return;
+    }
+
+    AVStream* stream = formatContext->streams[streamIndex];
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext* codecContext = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!codecContext || avcodec_parameters_to_context(codecContext, stream->codecpar) < 0) {
+        avcodec_free_context(&codecContext);
+        avformat_close_input(&formatContext);
+        return;
+    }
+
+    // Keyframes only - the decoder never touches the frames in between
+    codecContext->thread_count = 2;
+    codecContext->skip_frame = AVDISCARD_NONKEY;
+
+    if (avcodec_open2(codecContext, codec, nullptr) < 0) {
+        avcodec_free_context(&codecContext);
+        avformat_close_input(&formatContext);
+        return;
+    }
+
+    // Thumbnail size: same aspect as the (region of the) frame, even dimensions
+    FrameRegion region = options.region;
+    if (region.isWhole()) region = FrameRegion{0, 0, codecContext->width, codecContext->height};
+    int thumbWidth = std::min(MAX_THUMBNAIL_WIDTH, region.width) & ~1;
+    int thumbHeight = std::max(2, (int)((int64_t)region.height * thumbWidth / region.width) & ~1);
+
+    int64_t startPts = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+    double timeBase = av_q2d(stream->time_base);
+
+    SwsContext* swsContext = nullptr;
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    int lastStored = -1;
+
+    auto receiveFrames = [&]() {
+        while (avcodec_receive_frame(codecContext, frame) >= 0) {
+            if (frame->best_effort_timestamp == AV_NOPTS_VALUE) continue;
+            int frameIndex = (int)std::llround((frame->best_effort_timestamp - startPts) * timeBase * fps);
+            if (frameIndex < 0 || frameIndex >= totalFrames) continue;
+
+            int interval;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                interval = intervalFrames;
+            }
+            if (lastStored >= 0 && interval > 0 && frameIndex - lastStored < interval) continue;
+
+            if (region.x + region.width > frame->width || region.y + region.height > frame->height) continue;
+            swsContext = sws_getCachedContext(swsContext,
+                region.width, region.height, (AVPixelFormat)frame->format,
+                thumbWidth, thumbHeight, AV_PIX_FMT_RGB24,
+                SWS_AREA, nullptr, nullptr, nullptr);
+            if (!swsContext) continue;
+
+            VideoFrame thumbnail;
+            thumbnail.width = thumbWidth;
+            thumbnail.height = thumbHeight;
+            thumbnail.linesize = thumbWidth * 3;
+            thumbnail.data.resize((size_t)thumbnail.linesize * thumbHeight);
+
+            uint8_t* dest[1] = { thumbnail.data.data() };
+            int destLinesize[1] = { thumbnail.linesize };
+            const uint8_t* source[4];
+            region.cropPlanes(frame, source);
+            sws_scale(swsContext, source, frame->linesize, 0, region.height, dest, destLinesize);
+
+            addThumbnail(frameIndex, std::move(thumbnail));
+            lastStored = frameIndex;
+        }
+    };
+
+    while (!shouldStop && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex && (packet->flags & AV_PKT_FLAG_KEY)) {
+            if (avcodec_send_packet(codecContext, packet) >= 0) {
+                receiveFrames();
+            }
+        }
+        av_packet_unref(packet);
+    }
+    if (!shouldStop && avcodec_send_packet(codecContext, nullptr) >= 0) {
+        receiveFrames();
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    sws_freeContext(swsContext);
+    avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+
+    if (shouldStop) return;
+
+    complete = true;
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        DEBUG_PRINT("Built " << thumbnails.size() << " thumbnails (" << thumbWidth << "x" << thumbHeight
+                    << ", " << usedBytes / (1024 * 1024) << " MB) in " << elapsed.count() << " ms");
+    }
+
+    if (!options.cachePath.empty()) {
+        saveCache();
+    }
+}
+
+// Identifies the exact source file and stream the cache was built from
+std::string ThumbnailIndex::sourceSignature() const {
+    std::error_code error;
+    auto size = std::filesystem::file_size(videoPath, error);
+    auto modified = std::filesystem::last_write_time(videoPath, error);
+    std::string signature = videoPath + "|" + std::to_string(size) + "|" +
+                            std::to_string(modified.time_since_epoch().count()) + "|" + std::to_string(MAX_THUMBNAIL_WIDTH) +
+                            "|stream " + std::to_string(streamIndex);
+    if (!options.region.isWhole()) {
+        signature += "|" + std::to_string(options.region.x) + "," + std::to_string(options.region.y) + "," +
+                     std::to_string(options.region.width) + "x" + std::to_string(options.region.height);
+    }
+    return signature;
+}
+
+bool ThumbnailIndex::loadCache() {
+    std::ifstream file(options.cachePath, std::ios::binary);
+    if (!file) return false;
+
+    char magic[8];
+    uint32_t signatureLength = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) return false;
+    if (!file.read(reinterpret_cast<char*>(&signatureLength), sizeof(signatureLength)) || signatureLength > 4096) return false;
+
+    std::string signature(signatureLength, '\0');
+    if (!file.read(&signature[0], signatureLength) || signature != sourceSignature()) {
+        DEBUG_PRINT("Cache " << options.cachePath << " is for a different file - rebuilding");
+        return false;
+    }
+
+    uint32_t count = 0;
+    int32_t thumbWidth = 0, thumbHeight = 0;
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    file.read(reinterpret_cast<char*>(&thumbWidth), sizeof(thumbWidth));
+    file.read(reinterpret_cast<char*>(&thumbHeight), sizeof(thumbHeight));
+    if (!file || thumbWidth <= 0 || thumbHeight <= 0 || thumbWidth > MAX_THUMBNAIL_WIDTH) return false;
+
+    size_t frameBytes = (size_t)thumbWidth * thumbHeight * 3;
+    for (uint32_t i = 0; i < count && !shouldStop; i++) {
+        int32_t frameIndex = 0;
+        VideoFrame thumbnail;
+        thumbnail.width = thumbWidth;
+        thumbnail.height = thumbHeight;
+        thumbnail.linesize = thumbWidth * 3;
+        thumbnail.data.resize(frameBytes);
+        if (!file.read(reinterpret_cast<char*>(&frameIndex), sizeof(frameIndex)) ||
+            !file.read(reinterpret_cast<char*>(thumbnail.data.data()), frameBytes)) {
+            break;
+        }
+        addThumbnail(frameIndex, std::move(thumbnail));
+    }
+
+    DEBUG_PRINT("Loaded " << getCount() << " thumbnails from " << options.cachePath);
+    return getCount() > 0;
+}
+
+void ThumbnailIndex::saveCache() const {
+    std::string tempPath = options.cachePath + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        DEBUG_PRINT("Cannot write cache " << tempPath);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (thumbnails.empty()) return;
+
+    std::string signature = sourceSignature();
+    uint32_t signatureLength = (uint32_t)signature.size();
+    uint32_t count = (uint32_t)thumbnails.size();
+    int32_t thumbWidth = thumbnails.begin()->second->width;
+    int32_t thumbHeight = thumbnails.begin()->second->height;
+
+    file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&signatureLength), sizeof(signatureLength));
+    file.write(signature.data(), signatureLength);
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(&thumbWidth), sizeof(thumbWidth));
+    file.write(reinterpret_cast<const char*>(&thumbHeight), sizeof(thumbHeight));
+
+    for (const auto& entry : thumbnails) {
+        int32_t frameIndex = entry.first;
+        file.write(reinterpret_cast<const char*>(&frameIndex), sizeof(frameIndex));
+        file.write(reinterpret_cast<const char*>(entry.second->data.data()), entry.second->data.size());
+    }
+    file.close();
+
+    // Atomic replace so a crash mid-write never leaves a truncated cache behind
+    std::error_code error;
+    std::filesystem::rename(tempPath, options.cachePath, error);
+    if (error) {
+        DEBUG_PRINT("Cannot write cache " << options.cachePath << ": " << error.message());
+    } else {
+        DEBUG_PRINT("Saved " << count << " thumbnails to " << options.cachePath);
+    }
+}
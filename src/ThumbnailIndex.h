@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+#include "VideoFrame.h"
+#include "FrameRegion.h"
+
+// Low-resolution frames at every keyframe (or every N seconds), built in the
+// background with its own demuxer/decoder so it never contends with playback.
+// On a locate to an uncached position the renderer shows the nearest
+// thumbnail immediately while the full-resolution decode catches up.
+class ThumbnailIndex {
+public:
+    struct Options {
+        size_t budgetBytes = 128ull * 1024 * 1024;
+        double intervalSeconds = 0.0;  // 0 = every keyframe
+        std::string cachePath;         // Persist/reload the index here ("" = memory only)
+        FrameRegion region;            // Part of the frame to keep (set by VideoPlayer)
+    };
+
+    ThumbnailIndex(const std::string& videoPath, int streamIndex, double fps, int totalFrames,
+                   const Options& options);
+    ~ThumbnailIndex();
+
+    // Closest thumbnail to frameIndex, or nullptr if none is built yet
+    std::shared_ptr<const VideoFrame> nearest(int frameIndex) const;
+
+    bool isComplete() const { return complete.load(std::memory_order_relaxed); }
+    size_t getCount() const;
+
+    static constexpr int MAX_THUMBNAIL_WIDTH = 320;
+
+private:
+    std::string videoPath;
+    int streamIndex;
+    double fps;
+    int totalFrames;
+    Options options;
+
+    mutable std::mutex mutex;
+    std::map<int, std::shared_ptr<const VideoFrame>> thumbnails;
+    size_t usedBytes = 0;
+    int intervalFrames = 0;  // Grows when thinning to stay inside the budget
+
+    std::thread builderThread;
+    std::atomic<bool> shouldStop{false};
+    std::atomic<bool> complete{false};
+
+    void buildTask();
+    void addThumbnail(int frameIndex, VideoFrame&& thumbnail);
+    void thinOut();  // Must be called with mutex locked
+
+    bool loadCache();
+    void saveCache() const;
+    std::string sourceSignature() const;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "FrameMemory.h"
+
+// Pixel storage drawn from the (optionally huge-page, mlock'ed) frame pool
+using FrameBuffer = std::vector<uint8_t, FrameAllocator<uint8_t>>;
+
+struct VideoFrame {
+    // RGB24 packed rows, or YUV16: a high-bit-depth (10/12-bit) frame kept as
+    // the decoder's planes of 16-bit samples, converted to RGB by the shader
+    enum Format : uint8_t { RGB24, YUV16 };
+
+    FrameBuffer data;  // Pixel data (all planes, back to back)
+    int width;
+    int height;
+    int linesize;
+    Format format = RGB24;
+
+    // YUV16 only
+    struct Plane {
+        size_t offset = 0;  // Into data
+        int linesize = 0;
+        int width = 0;      // In texels - a CbCr pair is one texel of a semi-planar chroma plane
+        int height = 0;
+    };
+    Plane planes[3];
+    int planeCount = 0;        // 2 = semi-planar (Y + interleaved CbCr, e.g. P010), 3 = planar
+    float sampleScale = 1.0f;  // Normalised 16-bit sample * sampleScale = 0..1 of the source bit depth
+    int bitDepth = 8;          // Source bits per sample - limited-range levels scale with it
+    int colorSpace = 0;        // AVColorSpace
+    bool fullRange = false;
+
+    // Identity of the pixel buffer: frames with equal content share one
+    // buffer and one id, so the renderer can skip re-uploading it
+    uint64_t contentHash = 0;
+    uint64_t bufferId = 0;
+
+    // Pixels owned elsewhere (a shared-memory ring slot) instead of data,
+    // held until externalOwner goes. Only live frames use this - cached
+    // frames always own their pixels.
+    const uint8_t* externalData = nullptr;
+    size_t externalSize = 0;
+    std::shared_ptr<const void> externalOwner;
+
+    const uint8_t* pixels() const { return externalData ? externalData : data.data(); }
+    size_t byteSize() const { return externalData ? externalSize : data.size(); }
+
+    static uint64_t allocateBufferId() {
+        static std::atomic<uint64_t> nextBufferId{1};
+        return nextBufferId.fetch_add(1, std::memory_order_relaxed);
+    }
+};
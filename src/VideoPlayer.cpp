@@ -1,20 +1,99 @@
 #include "VideoPlayer.h"
+#include "FrameHash.h"
+#include "GopBoundary.h"
+#include "ImageSequence.h"
 #include <iostream>
 #include <cstring>
 #include <cmath>
+extern "C" {
+#include <libavutil/pixdesc.h>
+}
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #define DEBUG_PRINT(msg) do { \
     std::cout << "[VideoPlayer] " << msg << std::endl; \
     std::cout.flush(); \
 } while(0)
 
+namespace {
+// Scalers for convert jobs, one set per pool worker (sws contexts aren't thread-safe)
+struct ThreadScalers {
+    struct Entry {
+        int width, height;
+        AVPixelFormat format;
+        SwsContext* context;
+    };
+    std::vector<Entry> entries;
+
+    SwsContext* get(int width, int height, AVPixelFormat format) {
+        for (const Entry& entry : entries) {
+            if (entry.width == width && entry.height == height && entry.format == format) return entry.context;
+        }
+        SwsContext* context = sws_getContext(width, height, format, width, height, AV_PIX_FMT_RGB24,
+                                             SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (context) entries.push_back({width, height, format, context});
+        return context;
+    }
+
+    ~ThreadScalers() {
+        for (const Entry& entry : entries) sws_freeContext(entry.context);
+    }
+};
+thread_local ThreadScalers scalers;
+
+// Little-endian YUV with more than 8 bits per sample in 16-bit words, planar
+// (yuv420p10, yuv422p10, yuv444p12, ...) or semi-planar (p010, p016)
+bool isHighBitDepthYuv(AVPixelFormat format) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+    if (!desc || desc->nb_components != 3) return false;
+    if (desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL)) {
+        return false;
+    }
+    if (!(desc->flags & AV_PIX_FMT_FLAG_PLANAR) || desc->comp[0].depth <= 8 || desc->comp[0].step != 2) {
+        return false;
+    }
+    int planes = av_pix_fmt_count_planes(format);
+    return planes == 2 || planes == 3;
+}
+
+// Keyframe flag of a decoded picture. Packet flags follow decode order, which
+// differs from output order once there are B-frames.
+bool isKeyFrame(const AVFrame* frame) {
+#ifdef AV_FRAME_FLAG_KEY
+    return frame->flags & AV_FRAME_FLAG_KEY;
+#else
+    return frame->key_frame;
+#endif
+}
+}
+
 VideoPlayer::~VideoPlayer() {
-    // Stop decoder thread
+    // Stop decoding: drop our queued pool jobs and wait out running ones
     shouldStopDecoder = true;
-    if (decoderThread.joinable()) {
-        decoderThread.join();
+    rawSource.reset();  // Joins the reader, which feeds the cache
+    if (decodePoolClient) {
+        DecodePool::instance().removeOwner(this);
+        DecodePool::instance().unregisterClient();
+    }
+    av_frame_free(&decoderState.frame);
+    av_packet_free(&decoderState.packet);
+
+    // Nobody will decode these any more - wake anyone still waiting on them
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        for (auto& entry : pendingRequests) {
+            entry.second->cancel();
+        }
+        pendingRequests.clear();
     }
 
+    thumbnails.reset();
+
+    // Stop cold tier workers before the hot cache they promote into goes away
+    coldCache.reset();
+
     // Clean up FFmpeg contexts
     closeFFmpegContexts();
 
@@ -22,22 +101,78 @@ VideoPlayer::~VideoPlayer() {
     std::lock_guard<std::mutex> lock(cacheMutex);
     frameCache.clear();
     cacheOrder.clear();
+    hashIndex.clear();
 }
 
 void VideoPlayer::closeFFmpegContexts() {
-    if (swsContext) {
-        sws_freeContext(swsContext);
-        swsContext = nullptr;
-    }
     if (codecContext) {
         avcodec_free_context(&codecContext);
     }
+    if (seekCodecContext) {
+        avcodec_free_context(&seekCodecContext);
+    }
+    activeCodec = nullptr;
     if (formatContext) {
         avformat_close_input(&formatContext);
     }
 }
 
+VideoPlayer::CodecThreading VideoPlayer::parseCodecThreading(const std::string& mode, int threads) {
+    CodecThreading threading;
+    threading.threadCount = threads;
+    if (mode == "slice") {
+        threading.threadType = FF_THREAD_SLICE;
+    } else if (mode == "frame+slice" || mode == "auto") {
+        threading.threadType = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    } else if (mode == "none") {
+        threading.threadType = FF_THREAD_SLICE;
+        threading.threadCount = 1;
+    } else {
+        threading.threadType = FF_THREAD_FRAME;
+    }
+    return threading;
+}
+
+const char* VideoPlayer::threadingName(const AVCodecContext* context) {
+    if (context->thread_count <= 1 || context->active_thread_type == 0) return "single-threaded";
+    if (context->active_thread_type & FF_THREAD_FRAME) return "frame threads";
+    return "slice threads";
+}
+
+AVCodecContext* VideoPlayer::openCodecContext(const AVCodec* codec, const AVCodecParameters* codecParams,
+                                              const CodecThreading& threading) {
+    AVCodecContext* context = avcodec_alloc_context3(codec);
+    if (!context) {
+        errorMessage = "Failed to allocate codec context";
+        return nullptr;
+    }
+
+    if (avcodec_parameters_to_context(context, codecParams) < 0) {
+        errorMessage = "Failed to copy codec parameters";
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+
+    context->thread_type = threading.threadType;
+    context->thread_count = (threading.threadCount > 0) ? threading.threadCount
+                                                        : DecodePool::instance().codecThreadsPerContext();
+
+    if (avcodec_open2(context, codec, nullptr) < 0) {
+        errorMessage = "Failed to open codec";
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    return context;
+}
+
 bool VideoPlayer::loadVideo(const std::string& filePath) {
+    if (RawFrameSource::isRawUri(filePath)) {
+        return loadRawStream(filePath);
+    }
+    if (ImageSequence::isSequence(filePath)) {
+        return loadImageSequence(filePath);
+    }
+
     DEBUG_PRINT("Loading video: " << filePath);
 
     // Open video file
@@ -52,18 +187,23 @@ bool VideoPlayer::loadVideo(const std::string& filePath) {
         return false;
     }
 
-    // Find video stream
+    // Find our video stream; the demuxer drops every other stream's packets
     AVCodecParameters* codecParams = nullptr;
+    int videoStreams = 0;
     for (unsigned int i = 0; i < formatContext->nb_streams; i++) {
-        if (formatContext->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+        AVStream* stream = formatContext->streams[i];
+        if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && videoStreams++ == videoStreamNumber) {
             videoStreamIndex = i;
-            codecParams = formatContext->streams[i]->codecpar;
-            break;
+            codecParams = stream->codecpar;
+        } else {
+            stream->discard = AVDISCARD_ALL;
         }
     }
 
     if (videoStreamIndex == -1) {
-        errorMessage = "No video stream found";
+        errorMessage = videoStreams ? "Video stream " + std::to_string(videoStreamNumber) + " not found (file has " +
+                                      std::to_string(videoStreams) + ")"
+                                    : "No video stream found";
         closeFFmpegContexts();
         return false;
     }
@@ -77,8 +217,26 @@ bool VideoPlayer::loadVideo(const std::string& filePath) {
     duration = (double)formatContext->duration / AV_TIME_BASE;
     totalFrames = (int)(duration * fps);
 
-    DEBUG_PRINT("Video info: " << codecParams->width << "x" << codecParams->height
+    // TT/BT: top field first; BB/TB: bottom field first (second letter = display order)
+    switch (codecParams->field_order) {
+        case AV_FIELD_TT:
+        case AV_FIELD_BT:
+            fieldOrder = FieldOrder::TopFirst;
+            break;
+        case AV_FIELD_BB:
+        case AV_FIELD_TB:
+            fieldOrder = FieldOrder::BottomFirst;
+            break;
+        default:
+            fieldOrder = FieldOrder::Progressive;
+            break;
+    }
+
+    DEBUG_PRINT("Video info (stream " << videoStreamNumber << "): " << codecParams->width << "x" << codecParams->height
                 << " @ " << fps << " fps, duration: " << duration << "s, frames: " << totalFrames);
+    if (fieldOrder != FieldOrder::Progressive) {
+        DEBUG_PRINT("Interlaced source, " << (fieldOrder == FieldOrder::TopFirst ? "top" : "bottom") << " field first");
+    }
 
     // Find decoder
     const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
@@ -88,49 +246,60 @@ bool VideoPlayer::loadVideo(const std::string& filePath) {
         return false;
     }
 
-    codecContext = avcodec_alloc_context3(codec);
+    // Share the cores with every other player's codec instead of each taking all of them
+    DecodePool::instance().registerClient();
+    decodePoolClient = true;
+
+    // One context per role: frame threading for throughput while playing,
+    // slice threading (no added delay) for locates and scrubbing
+    codecContext = openCodecContext(codec, codecParams, playbackThreading);
     if (!codecContext) {
-        errorMessage = "Failed to allocate codec context";
         closeFFmpegContexts();
         return false;
     }
-
-    if (avcodec_parameters_to_context(codecContext, codecParams) < 0) {
-        errorMessage = "Failed to copy codec parameters";
+    seekCodecContext = openCodecContext(codec, codecParams, seekThreading);
+    if (!seekCodecContext) {
         closeFFmpegContexts();
         return false;
     }
+    activeCodec = codecContext;
 
-    codecContext->thread_count = 0;
+    if (intraFastPath && IntraFrameDecoder::isIntraOnly(codecParams)) {
+        intraDecoder = std::make_unique<IntraFrameDecoder>(filePath, videoStreamIndex, fps, totalFrames);
+        if (intraDecoder->getContextCount() == 0) {
+            intraDecoder.reset();  // Couldn't open a second demuxer - use the sequential decoder
+        }
+    }
 
-    if (avcodec_open2(codecContext, codec, nullptr) < 0) {
-        errorMessage = "Failed to open codec";
-        closeFFmpegContexts();
-        return false;
+    if (highBitDepth && isHighBitDepthYuv(codecContext->pix_fmt)) {
+        DEBUG_PRINT("High bit depth: caching " << av_get_pix_fmt_name(codecContext->pix_fmt)
+                    << " planes, converted to RGB on the GPU");
     }
 
+    DEBUG_PRINT("Codec threading - playback: " << threadingName(codecContext)
+                << ", seek: " << threadingName(seekCodecContext));
+
     width = codecContext->width;
     height = codecContext->height;
+    applyRegion();
 
-    // Setup scaler to convert to RGB24
-    swsContext = sws_getContext(
-        width, height, codecContext->pix_fmt,
-        width, height, AV_PIX_FMT_RGB24,
-        SWS_BILINEAR, nullptr, nullptr, nullptr
-    );
-
-    if (!swsContext) {
+    // Converts run on pool threads with per-thread scalers - check one can be made
+    if (!scalers.get(width, height, codecContext->pix_fmt)) {
         errorMessage = "Failed to create scaler context";
         closeFFmpegContexts();
         return false;
     }
 
+    // Every cached frame has the same size - pre-fault the pool before the first decode
+    if (reserveFrameMemory) {
+        FrameMemory::reserve(cachedFrameBytes(codecContext->pix_fmt), maxCachedFrames.load() + FRAME_POOL_HEADROOM);
+    }
+
     // Pre-load first 150 frames sequentially (fast startup + seamless looping)
     DEBUG_PRINT("Pre-loading first 150 frames...");
 
     AVPacket* packet = av_packet_alloc();
     AVFrame* frame = av_frame_alloc();
-    int numBytes = width * height * 3;
     int frameCount = 0;
     int maxPreload = std::min(150, totalFrames);
 
@@ -143,25 +312,7 @@ bool VideoPlayer::loadVideo(const std::string& filePath) {
         if (packet->stream_index == videoStreamIndex) {
             if (avcodec_send_packet(codecContext, packet) >= 0) {
                 while (avcodec_receive_frame(codecContext, frame) >= 0) {
-                    VideoFrame vf;
-                    vf.width = width;
-                    vf.height = height;
-                    vf.linesize = width * 3;
-                    vf.data.resize(numBytes);
-
-                    uint8_t* dest[1] = { vf.data.data() };
-                    int destLinesize[1] = { vf.linesize };
-
-                    sws_scale(swsContext,
-                             frame->data, frame->linesize, 0, height,
-                             dest, destLinesize);
-
-                    // Add to cache
-                    {
-                        std::lock_guard<std::mutex> lock(cacheMutex);
-                        frameCache[frameCount] = std::move(vf);
-                        cacheOrder.push_back(frameCount);
-                    }
+                    cacheFrame(frameCount, convertFrame(frame));
 
                     frameCount++;
                     if (frameCount >= maxPreload) break;
@@ -177,19 +328,47 @@ bool VideoPlayer::loadVideo(const std::string& filePath) {
     DEBUG_PRINT("Pre-loaded " << frameCount << " frames");
 
     // Calculate expected memory usage
-    size_t expectedMemory = MAX_CACHED_FRAMES * width * height * 3;
+    size_t expectedMemory = maxCachedFrames.load() * cachedFrameBytes(codecContext->pix_fmt);
     double memoryMB = (double)expectedMemory / (1024.0 * 1024.0);
-    DEBUG_PRINT("Ring buffer size: " << MAX_CACHED_FRAMES << " frames (~" << memoryMB << " MB)");
+    DEBUG_PRINT("Ring buffer size: " << maxCachedFrames.load() << " frames (~" << memoryMB << " MB)");
 
-    // Start background decoder thread
-    shouldStopDecoder = false;
-    decoderThread = std::thread(&VideoPlayer::backgroundDecoderTask, this);
+    if (coldCacheBudgetBytes > 0) {
+        coldCache = std::make_unique<ColdFrameCache>((size_t)(coldCacheBudgetBytes * cacheShare),
+            [this](int frameIndex, VideoFrame&& promoted) {
+                cacheFrame(frameIndex, std::move(promoted));
+            });
+    }
+
+    if (thumbnailsEnabled) {
+        if (regionOfInterest.isSet()) thumbnailOptions.region = region;
+        thumbnails = std::make_unique<ThumbnailIndex>(filePath, videoStreamIndex, fps, totalFrames, thumbnailOptions);
+    }
 
+    // Start decoding ahead on the shared pool
+    decoderState.packet = av_packet_alloc();
+    decoderState.frame = av_frame_alloc();
+    shouldStopDecoder = false;
     loaded = true;
+    scheduleDecodeSlice(FrameRequest::Clock::now());
+
     DEBUG_PRINT("Video loaded successfully (on-demand decoding enabled)");
     return true;
 }
 
+int VideoPlayer::countVideoStreams(const std::string& filePath) {
+    AVFormatContext* format = nullptr;
+    if (avformat_open_input(&format, filePath.c_str(), nullptr, nullptr) < 0) return 0;
+
+    int count = 0;
+    if (avformat_find_stream_info(format, nullptr) >= 0) {
+        for (unsigned int i = 0; i < format->nb_streams; i++) {
+            if (format->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) count++;
+        }
+    }
+    avformat_close_input(&format);
+    return count;
+}
+
 void VideoPlayer::play() {
     if (!loaded) return;
     playing = true;
@@ -209,7 +388,7 @@ void VideoPlayer::seek(double seconds) {
     if (!loaded || totalFrames == 0) return;
 
     int targetFrame = (int)(seconds * fps);
-    currentFrameIndex = std::max(0, std::min(targetFrame, totalFrames - 1));
+    currentFrameIndex = std::max(0, std::min(targetFrame, lastFrameIndex()));
     lastFrameTime = std::chrono::steady_clock::now();
 
     // DEBUG_PRINT("Seeked to " << seconds << "s (frame " << currentFrameIndex << ")");
@@ -225,8 +404,8 @@ void VideoPlayer::syncToTimestamp(double audioTimestamp) {
 
     int targetFrame = (int)(loopedTime * fps);
 
-    // Clamp to valid range
-    targetFrame = std::max(0, std::min(targetFrame, totalFrames - 1));
+    // Clamp to the frames the stream really has (totalFrames can overestimate)
+    targetFrame = std::max(0, std::min(targetFrame, lastFrameIndex()));
 
     // Update frame index directly - no accumulation, no drift!
     currentFrameIndex.store(targetFrame, std::memory_order_relaxed);
@@ -236,30 +415,68 @@ void VideoPlayer::syncToTimestamp(double audioTimestamp) {
     lastSyncTime = std::chrono::steady_clock::now();
 }
 
-const VideoFrame* VideoPlayer::getCurrentFrame() {
+std::shared_ptr<const VideoFrame> VideoPlayer::peekFrame(int frameIndex) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = frameCache.find(frameIndex);
+    return it != frameCache.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const VideoFrame> VideoPlayer::getCurrentFrame() {
     if (!loaded) return nullptr;
 
+    if (rawSource && rawOptions.latestOnly) {
+        std::lock_guard<std::mutex> lock(latestMutex);
+        if (!latestFrame) missingFrames.fetch_add(1, std::memory_order_relaxed);
+        return latestFrame;
+    }
+
     int frameIndex = currentFrameIndex.load(std::memory_order_relaxed);
     ensureFrameLoaded(frameIndex);
 
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    auto it = frameCache.find(frameIndex);
-    if (it != frameCache.end()) {
-        return &it->second;
-    }
-
-    // Frame not in cache yet - return closest available frame to avoid blank screen
-    // Try nearby frames (decoder might be slightly behind)
-    for (int offset = -5; offset <= 5; offset++) {
-        int nearbyFrame = frameIndex + offset;
-        if (nearbyFrame >= 0 && nearbyFrame < totalFrames) {
-            auto nearIt = frameCache.find(nearbyFrame);
-            if (nearIt != frameCache.end()) {
-                return &nearIt->second;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = frameCache.find(frameIndex);
+        if (it != frameCache.end()) {
+            return it->second;
+        }
+    }
+
+    // Missed: the playhead frame is due at the next refresh. Keep one request in
+    // the decode engine for it, replacing the previous one when the playhead moves.
+    if (!renderRequest || renderRequest->getFrameIndex() != frameIndex) {
+        if (renderRequest) renderRequest->cancel();
+        renderRequest = requestFrame(frameIndex, FrameRequest::Clock::now() + frameDuration);
+    }
+    if (auto requested = renderRequest->tryGet()) {
+        return requested;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        // Frame not in cache yet - return closest available frame to avoid blank screen
+        // Try nearby frames (decoder might be slightly behind)
+        for (int offset = -5; offset <= 5; offset++) {
+            int nearbyFrame = frameIndex + offset;
+            if (nearbyFrame >= 0 && nearbyFrame < totalFrames) {
+                auto nearIt = frameCache.find(nearbyFrame);
+                if (nearIt != frameCache.end()) {
+                    staleFramesServed.fetch_add(1, std::memory_order_relaxed);
+                    return nearIt->second;
+                }
             }
         }
     }
 
+    // Far from anything decoded (a locate) - show the nearest keyframe thumbnail
+    // instead of holding the old picture until the decoder gets there
+    if (thumbnails) {
+        if (auto thumbnail = thumbnails->nearest(frameIndex)) {
+            thumbnailsServed.fetch_add(1, std::memory_order_relaxed);
+            return thumbnail;
+        }
+    }
+
+    missingFrames.fetch_add(1, std::memory_order_relaxed);
     return nullptr;  // No frames available at all
 }
 
@@ -298,6 +515,139 @@ void VideoPlayer::update() {
         lastFrameTime += frameDuration;
     }
 }
+
+// Image sequence: every frame is its own file, so there is no container
+// demuxer or sequential decoder - all decoding goes through the intra path
+bool VideoPlayer::loadImageSequence(const std::string& path) {
+    DEBUG_PRINT("Loading image sequence: " << path);
+
+    std::vector<std::string> files = ImageSequence::resolve(path);
+    if (files.empty()) {
+        errorMessage = "No image files found for sequence " + path;
+        return false;
+    }
+
+    // The first image describes the sequence (codec, size, pixel format)
+    if (avformat_open_input(&formatContext, files.front().c_str(), nullptr, nullptr) < 0 ||
+        avformat_find_stream_info(formatContext, nullptr) < 0 || formatContext->nb_streams < 1) {
+        errorMessage = "Failed to open " + files.front();
+        closeFFmpegContexts();
+        return false;
+    }
+    AVCodecParameters* codecParams = formatContext->streams[0]->codecpar;
+
+    fps = (sequenceFrameRate > 0) ? sequenceFrameRate : 25.0;
+    frameDuration = std::chrono::microseconds((int64_t)(1000000.0 / fps));
+    totalFrames = (int)files.size();
+    duration = totalFrames / fps;
+    width = codecParams->width;
+    height = codecParams->height;
+    if (width > 0 && height > 0) applyRegion();
+
+    DecodePool::instance().registerClient();
+    decodePoolClient = true;
+
+    intraDecoder = std::make_unique<IntraFrameDecoder>(std::move(files), codecParams);
+    bool scalerOk = scalers.get(width, height, (AVPixelFormat)codecParams->format) != nullptr;
+    closeFFmpegContexts();
+
+    if (intraDecoder->getContextCount() == 0) {
+        errorMessage = "No decoder for the sequence's image format";
+        intraDecoder.reset();
+        return false;
+    }
+    if (width <= 0 || height <= 0 || !scalerOk) {
+        errorMessage = "Failed to create scaler context";
+        intraDecoder.reset();
+        return false;
+    }
+
+    DEBUG_PRINT("Sequence info: " << width << "x" << height << " @ " << fps << " fps, "
+                << totalFrames << " frames");
+
+    if (reserveFrameMemory) {
+        FrameMemory::reserve((size_t)width * height * 3, maxCachedFrames.load() + FRAME_POOL_HEADROOM);
+    }
+
+    if (coldCacheBudgetBytes > 0) {
+        coldCache = std::make_unique<ColdFrameCache>((size_t)(coldCacheBudgetBytes * cacheShare),
+            [this](int frameIndex, VideoFrame&& promoted) {
+                cacheFrame(frameIndex, std::move(promoted));
+            });
+    }
+
+    // No preload: the intra decode slice fills the window around the playhead in parallel
+    shouldStopDecoder = false;
+    loaded = true;
+    scheduleDecodeSlice(FrameRequest::Clock::now());
+
+    DEBUG_PRINT("Image sequence loaded");
+    return true;
+}
+
+// Raw frames from another process: nothing to demux or decode. The timeline is
+// open-ended; each frame is cached at the playhead position it arrived at.
+bool VideoPlayer::loadRawStream(const std::string& uri) {
+    DEBUG_PRINT("Opening raw frame input: " << uri);
+
+    fps = (rawFrameRate > 0) ? rawFrameRate : 60.0;
+    frameDuration = std::chrono::microseconds((int64_t)(1000000.0 / fps));
+    duration = RAW_TIMELINE_SECONDS;
+    totalFrames = (int)(duration * fps);
+
+    // Live frames go straight to the screen - the cold tier only helps when caching
+    if (coldCacheBudgetBytes > 0 && !rawOptions.latestOnly) {
+        coldCache = std::make_unique<ColdFrameCache>((size_t)(coldCacheBudgetBytes * cacheShare),
+            [this](int frameIndex, VideoFrame&& promoted) {
+                cacheFrame(frameIndex, std::move(promoted));
+            });
+    }
+
+    rawSource = std::make_unique<RawFrameSource>(uri, rawOptions,
+        [this](VideoFrame&& frame) { onRawFrame(std::move(frame)); });
+    if (!rawSource->start()) {
+        errorMessage = rawSource->getErrorMessage();
+        rawSource.reset();
+        coldCache.reset();
+        return false;
+    }
+    width = sourceWidth = rawSource->getWidth();
+    height = sourceHeight = rawSource->getHeight();
+    if (regionOfInterest.isSet()) {
+        DEBUG_PRINT("Region of interest not supported for raw input - showing whole frames");
+    }
+
+    if (reserveFrameMemory && !rawOptions.latestOnly) {
+        FrameMemory::reserve((size_t)width * height * 3, maxCachedFrames.load() + FRAME_POOL_HEADROOM);
+    }
+
+    loaded = true;
+    DEBUG_PRINT("Raw input: " << width << "x" << height << " on a " << fps << " fps timeline"
+                << (rawOptions.latestOnly ? ", newest frame only" : ", cached at arrival position"));
+    return true;
+}
+
+// Reader thread: a raw frame has arrived
+void VideoPlayer::onRawFrame(VideoFrame&& frame) {
+    if (rawOptions.latestOnly) {
+        frame.bufferId = VideoFrame::allocateBufferId();
+        auto shared = std::make_shared<const VideoFrame>(std::move(frame));
+        std::lock_guard<std::mutex> lock(latestMutex);
+        latestFrame = std::move(shared);  // Releases the previous frame (and its ring slot)
+        return;
+    }
+
+    // Stamped against the transport: the frame belongs to the position playing now.
+    // A newer frame for the same position (transport stopped, producer faster than
+    // the timeline) replaces the older one.
+    int frameIndex = currentFrameIndex.load(std::memory_order_relaxed);
+    cacheFrame(frameIndex, std::move(frame), true);
+}
+
+RawFrameSource::Stats VideoPlayer::getRawInputStats() const {
+    return rawSource ? rawSource->getStats() : RawFrameSource::Stats{};
+}
+
 // Decode a single frame at the specified index
 bool VideoPlayer::decodeFrame(int frameIndex) {
     if (frameIndex < 0 || frameIndex >= totalFrames) return false;
@@ -310,6 +660,13 @@ bool VideoPlayer::decodeFrame(int frameIndex) {
         }
     }
 
+    // All-intra: one frame, one packet - no need to touch the shared demuxer
+    if (intraDecoder) {
+        return intraDecoder->decode(frameIndex, [this](int decodedIndex, const AVFrame* decoded) {
+            cacheIntraFrame(decodedIndex, decoded);
+        });
+    }
+
     // Lock FFmpeg contexts (NOT thread-safe!)
     std::lock_guard<std::mutex> decoderLock(decoderMutex);
 
@@ -319,7 +676,8 @@ bool VideoPlayer::decodeFrame(int frameIndex) {
         return false;
     }
 
-    avcodec_flush_buffers(codecContext);
+    // Locates use the low-latency context
+    avcodec_flush_buffers(seekCodecContext);
 
     AVPacket* packet = av_packet_alloc();
     AVFrame* frame = av_frame_alloc();
@@ -336,34 +694,15 @@ bool VideoPlayer::decodeFrame(int frameIndex) {
     // Read packets until we find our frame
     while (av_read_frame(formatContext, packet) >= 0 && framesRead < maxFramesToRead) {
         if (packet->stream_index == videoStreamIndex) {
-            if (avcodec_send_packet(codecContext, packet) >= 0) {
-                while (avcodec_receive_frame(codecContext, frame) >= 0) {
+            if (avcodec_send_packet(seekCodecContext, packet) >= 0) {
+                while (avcodec_receive_frame(seekCodecContext, frame) >= 0) {
                     int64_t framePts = frame->best_effort_timestamp;
                     framesRead++;
 
                     // Check if this is close to our target frame
                     if (std::abs(framePts - targetPts) < fps / 2) {
                         // This is our frame! Convert to RGB24
-                        VideoFrame vf;
-                        vf.width = width;
-                        vf.height = height;
-                        vf.linesize = width * 3;
-                        vf.data.resize(width * height * 3);
-
-                        uint8_t* dest[1] = { vf.data.data() };
-                        int destLinesize[1] = { vf.linesize };
-
-                        sws_scale(swsContext,
-                                 frame->data, frame->linesize, 0, height,
-                                 dest, destLinesize);
-
-                        // Add to cache
-                        {
-                            std::lock_guard<std::mutex> lock(cacheMutex);
-                            frameCache[frameIndex] = std::move(vf);
-                            cacheOrder.push_back(frameIndex);
-                            evictOldFrames();
-                        }
+                        cacheFrame(frameIndex, convertFrame(frame));
 
                         frameDecoded = true;
                         break;
@@ -389,141 +728,972 @@ void VideoPlayer::ensureFrameLoaded(int frameIndex) {
         return;  // Already loaded
     }
 
+    // Compressed in the cold tier - decompress on a worker, much cheaper than decoding
+    if (coldCache) {
+        coldCache->requestPromote(frameIndex);
+    }
+
     // Not in cache - background decoder thread will fetch it
     // Don't block the render thread!
 }
 
+// Insert a decoded frame into the hot cache, sharing the buffer of an identical frame.
+// replace: swap out a frame already cached at frameIndex in one step (raw input),
+// so readers never see the index missing.
+void VideoPlayer::cacheFrame(int frameIndex, VideoFrame&& frame, bool replace) {
+    frame.contentHash = FrameHash::hashSubsample(frame);
+
+    std::shared_ptr<const VideoFrame> candidate;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (!replace && frameCache.find(frameIndex) != frameCache.end()) {
+            return;  // Raced with another decode/promotion of the same frame (which fulfilled requests)
+        }
+        auto it = hashIndex.find(frame.contentHash);
+        if (it != hashIndex.end()) {
+            candidate = it->second.lock();
+        }
+    }
+
+    // The hash only covers a subsample - confirm with a full compare (outside the lock)
+    bool duplicate = candidate &&
+                     candidate->format == frame.format &&
+                     candidate->width == frame.width &&
+                     candidate->height == frame.height &&
+                     candidate->data.size() == frame.data.size() &&
+                     std::memcmp(candidate->data.data(), frame.data.data(), frame.data.size()) == 0;
+
+    std::shared_ptr<const VideoFrame> shared;
+    if (duplicate) {
+        shared = candidate;
+    } else {
+        frame.bufferId = VideoFrame::allocateBufferId();
+        shared = std::make_shared<const VideoFrame>(std::move(frame));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto existing = frameCache.find(frameIndex);
+        if (existing != frameCache.end()) {
+            if (!replace) return;
+            frameCache.erase(existing);
+            cacheOrder.remove(frameIndex);
+        }
+        // The cold tier may still hold an older picture for this index
+        if (replace && coldCache) {
+            coldCache->erase(frameIndex);
+        }
+        if (duplicate) {
+            dedupFrames++;
+            dedupBytesSaved += shared->data.size();
+        } else {
+            hashIndex[shared->contentHash] = shared;
+        }
+        frameCache[frameIndex] = shared;
+        cacheOrder.push_back(frameIndex);
+        evictOldFrames();
+    }
+
+    fulfilRequests(frameIndex, shared);
+}
+
+FrameRequestHandle VideoPlayer::requestFrame(int frameIndex, FrameRequest::Clock::time_point deadline) {
+    frameIndex = std::max(0, std::min(frameIndex, lastFrameIndex()));
+    auto request = std::make_shared<FrameRequest>(frameIndex, deadline);
+    requestsSubmitted.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = frameCache.find(frameIndex);
+        if (it != frameCache.end()) {
+            request->fulfil(it->second);
+            requestsFromCache.fetch_add(1, std::memory_order_relaxed);
+            return request;
+        }
+        if (coldCache) {
+            coldCache->requestPromote(frameIndex);
+        }
+    }
+
+    // Raw input has no decoder to ask: frames only arrive, stamped at the
+    // playhead. Nothing would ever take the request off the queue.
+    if (rawSource) {
+        request->fail();
+        requestsFailed.fetch_add(1, std::memory_order_relaxed);
+        return request;
+    }
+
+    // Queue before re-checking the cache, so a frame cached in between can't slip past us
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        pendingRequests.emplace(deadline, request);
+    }
+    std::shared_ptr<const VideoFrame> cached;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = frameCache.find(frameIndex);
+        if (it != frameCache.end()) {
+            cached = it->second;
+        }
+    }
+    if (cached) {
+        fulfilRequests(frameIndex, cached);
+    } else {
+        scheduleDecodeSlice(deadline);  // Re-evaluate now rather than at the next idle poll
+    }
+    return request;
+}
+
+// Hand a newly cached frame to every request waiting for it
+void VideoPlayer::fulfilRequests(int frameIndex, const std::shared_ptr<const VideoFrame>& frame) {
+    auto now = FrameRequest::Clock::now();
+    std::lock_guard<std::mutex> lock(requestMutex);
+    for (auto it = pendingRequests.begin(); it != pendingRequests.end();) {
+        const FrameRequestHandle& request = it->second;
+        if (request->getFrameIndex() != frameIndex) {
+            ++it;
+            continue;
+        }
+        if (request->fulfil(frame)) {
+            if (now <= request->getDeadline()) {
+                requestsMet.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                requestsMissed.fetch_add(1, std::memory_order_relaxed);
+                worstLateSeconds = std::max(worstLateSeconds,
+                    std::chrono::duration<double>(now - request->getDeadline()).count());
+            }
+        } else if (request->isCancelled()) {
+            requestsCancelled.fetch_add(1, std::memory_order_relaxed);
+        }
+        it = pendingRequests.erase(it);
+    }
+}
+
+// Wake every request for a frame the decoder can't produce, instead of
+// locating towards it forever
+void VideoPlayer::failRequests(int frameIndex, const char* reason) {
+    int failed = 0;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        for (auto it = pendingRequests.begin(); it != pendingRequests.end();) {
+            if (it->second->getFrameIndex() != frameIndex) {
+                ++it;
+                continue;
+            }
+            if (it->second->fail()) {
+                failed++;
+            } else if (it->second->isCancelled()) {
+                requestsCancelled.fetch_add(1, std::memory_order_relaxed);
+            }
+            it = pendingRequests.erase(it);
+        }
+    }
+    if (failed > 0) {
+        requestsFailed.fetch_add(failed, std::memory_order_relaxed);
+        DEBUG_PRINT("Request for frame " << frameIndex << " failed: " << reason);
+    }
+}
+
+// Highest index worth asking for: the real last frame once EOF has shown it
+int VideoPlayer::lastFrameIndex() const {
+    int last = lastStreamFrame.load(std::memory_order_relaxed);
+    return (last >= 0) ? std::min(last, totalFrames - 1) : totalFrames - 1;
+}
+
+// Earliest-deadline live request (nullptr if none). Drops cancelled requests on the way.
+FrameRequestHandle VideoPlayer::nextRequest() {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    while (!pendingRequests.empty()) {
+        auto it = pendingRequests.begin();
+        if (!it->second->isCancelled()) {
+            return it->second;
+        }
+        requestsCancelled.fetch_add(1, std::memory_order_relaxed);
+        pendingRequests.erase(it);
+    }
+    return nullptr;
+}
+
+std::vector<std::pair<FrameRequest::Clock::time_point, int>> VideoPlayer::pendingRequestFrames() const {
+    std::vector<std::pair<FrameRequest::Clock::time_point, int>> frames;
+    std::lock_guard<std::mutex> lock(requestMutex);
+    for (const auto& entry : pendingRequests) {
+        if (!entry.second->isCancelled()) {
+            frames.emplace_back(entry.first, entry.second->getFrameIndex());
+        }
+    }
+    return frames;
+}
+
+bool VideoPlayer::isRequested(int frameIndex) const {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    for (const auto& entry : pendingRequests) {
+        if (entry.second->getFrameIndex() == frameIndex) return true;
+    }
+    return false;
+}
+
+bool VideoPlayer::isCached(int frameIndex) const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return frameCache.find(frameIndex) != frameCache.end() || (coldCache && coldCache->contains(frameIndex));
+}
+
+VideoPlayer::RequestStats VideoPlayer::getRequestStats() const {
+    RequestStats stats;
+    stats.submitted = requestsSubmitted.load(std::memory_order_relaxed);
+    stats.fromCache = requestsFromCache.load(std::memory_order_relaxed);
+    stats.met = requestsMet.load(std::memory_order_relaxed);
+    stats.missed = requestsMissed.load(std::memory_order_relaxed);
+    stats.cancelled = requestsCancelled.load(std::memory_order_relaxed);
+    stats.failed = requestsFailed.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(requestMutex);
+    stats.worstLateMs = worstLateSeconds * 1000.0;
+    stats.pending = pendingRequests.size();
+    return stats;
+}
+
 // Evict old frames if cache is too large (LRU)
 void VideoPlayer::evictOldFrames() {
     // Must be called with cacheMutex locked
-    while (frameCache.size() > MAX_CACHED_FRAMES) {
+    size_t limit = maxCachedFrames.load(std::memory_order_relaxed);
+    while (frameCache.size() > limit) {
         if (cacheOrder.empty()) break;
 
         int oldestFrame = cacheOrder.front();
         cacheOrder.pop_front();
-        frameCache.erase(oldestFrame);
+
+        auto it = frameCache.find(oldestFrame);
+        if (it == frameCache.end()) continue;
+
+        // Demote to the cold tier rather than dropping it outright
+        if (coldCache) {
+            coldCache->submit(oldestFrame, it->second);
+        }
+        frameCache.erase(it);
+    }
+
+    // Drop hash entries whose buffers are gone
+    if (hashIndex.size() > MAX_CACHED_FRAMES * 2) {
+        for (auto it = hashIndex.begin(); it != hashIndex.end();) {
+            if (it->second.expired()) {
+                it = hashIndex.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
 }
 
-// Background decoder thread - sequential decode ahead of playback
-void VideoPlayer::backgroundDecoderTask() {
-    DEBUG_PRINT("Background decoder thread started");
+void VideoPlayer::setCacheShare(double share) {
+    cacheShare = std::max(0.0, std::min(share, 1.0));
+    maxCachedFrames = std::max(MIN_CACHED_FRAMES, (size_t)(MAX_CACHED_FRAMES * cacheShare));
+}
 
-    AVPacket* packet = av_packet_alloc();
-    AVFrame* frame = av_frame_alloc();
-    int numBytes = width * height * 3;
+void VideoPlayer::setCacheBudgetScale(double scale, const std::string& reason) {
+    size_t hotLimit = std::max(MIN_CACHED_FRAMES, (size_t)(MAX_CACHED_FRAMES * cacheShare * scale));
+    size_t coldBudget = (size_t)(coldCacheBudgetBytes * cacheShare * scale);
 
-    int sequentialFrameIndex = 0;
-    bool needSeek = true;
-    int lastPlaybackFrame = 0;
+    size_t previousLimit = maxCachedFrames.exchange(hotLimit);
+    DEBUG_PRINT("Cache budget " << previousLimit << " -> " << hotLimit << " hot frames, "
+                << coldBudget / (1024 * 1024) << " MB cold (" << reason << ")");
 
-    while (!shouldStopDecoder) {  // Check at top of loop
-        if (!loaded) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            continue;
+    if (hotLimit < previousLimit) {
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            evictOldFrames();
+        }
+        // Hand the freed frame memory back to the kernel rather than keep it mapped
+        if (reserveFrameMemory) {
+            FrameMemory::trim(FRAME_POOL_HEADROOM);
+        }
+#ifdef __GLIBC__
+        else {
+            malloc_trim(0);
+        }
+#endif
+    }
+    if (coldCache) {
+        coldCache->setBudgetBytes(coldBudget);
+    }
+}
+
+VideoPlayer::CacheStats VideoPlayer::getCacheStats() const {
+    CacheStats stats;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        stats.hotFrames = frameCache.size();
+        stats.hotLimit = maxCachedFrames.load(std::memory_order_relaxed);
+        stats.dedupFrames = dedupFrames;
+        stats.dedupBytesSaved = dedupBytesSaved;
+    }
+    if (coldCache) {
+        stats.coldFrames = coldCache->getFrameCount();
+        stats.coldBytes = coldCache->getUsedBytes();
+    }
+    return stats;
+}
+
+// Feed one decoded frame's cost into the decode-ahead window.
+// The window must cover the worst stall we expect - a slow I-frame, or
+// re-decoding a whole GOP after a locate - with some safety margin, and the
+// less spare decode capacity we have the longer it takes to refill, so the
+// window grows as load approaches real time.
+void VideoPlayer::recordDecodeTiming(double frameSeconds, int frameIndex, bool keyframe) {
+    // GOP length: index distance between consecutive keyframes of one run
+    if (frameIndex < 0) {
+        lastKeyframeIndex = -1;
+    } else if (keyframe) {
+        if (lastKeyframeIndex >= 0 && frameIndex > lastKeyframeIndex) {
+            gopFrames.store(frameIndex - lastKeyframeIndex, std::memory_order_relaxed);
+        }
+        lastKeyframeIndex = frameIndex;
+    }
+
+    double avg = avgDecodeSeconds.load(std::memory_order_relaxed);
+    avg = (avg == 0.0) ? frameSeconds : avg + DECODE_TIME_EMA_ALPHA * (frameSeconds - avg);
+    avgDecodeSeconds.store(avg, std::memory_order_relaxed);
+
+    double peak = std::max(frameSeconds, peakDecodeSeconds.load(std::memory_order_relaxed) * PEAK_DECAY);
+    peakDecodeSeconds.store(peak, std::memory_order_relaxed);
+
+    double load = avg * fps;
+    double gopSeconds = gopFrames.load(std::memory_order_relaxed) * avg;
+    double spikeSeconds = std::max(peak, gopSeconds);
+    double spareCapacity = 1.0 - std::min(load, UNDER_PROVISIONED_LOAD);
+
+    double required = DECODE_AHEAD_SAFETY * spikeSeconds / spareCapacity;
+    double maxAhead = MAX_DECODE_AHEAD_CACHE_SHARE * maxCachedFrames.load(std::memory_order_relaxed) / fps;
+    double ahead = std::max(MIN_DECODE_AHEAD_SECONDS, std::min(required, maxAhead));
+    decodeAheadSeconds.store(ahead, std::memory_order_relaxed);
+
+    // Only meaningful while playing - paused decode-ahead is intentionally idle
+    bool behind = playing && (load >= UNDER_PROVISIONED_LOAD || required > maxAhead);
+    if (behind != underProvisioned.exchange(behind)) {
+        if (behind) {
+            DEBUG_PRINT("WARNING: decoder under-provisioned - " << (int)(load * 100)
+                        << "% of real time per frame, needs " << required
+                        << "s decode-ahead but cache allows " << maxAhead << "s");
+        } else {
+            DEBUG_PRINT("Decoder keeping up again (" << (int)(load * 100) << "% of real time)");
         }
+    }
+}
+
+int VideoPlayer::decodeAheadFrames() const {
+    int frames = (int)std::ceil(decodeAheadSeconds.load(std::memory_order_relaxed) * fps);
+    // Paused: just enough around the playhead for stepping and a quick resume
+    return playing ? frames : std::max(5, frames / 5);
+}
+
+VideoPlayer::DecodeStats VideoPlayer::getDecodeStats() const {
+    DecodeStats stats;
+    double avg = avgDecodeSeconds.load(std::memory_order_relaxed);
+    stats.avgFrameMs = avg * 1000.0;
+    stats.peakFrameMs = peakDecodeSeconds.load(std::memory_order_relaxed) * 1000.0;
+    stats.gopFrames = gopFrames.load(std::memory_order_relaxed);
+    stats.load = avg * fps;
+    stats.aheadSeconds = decodeAheadSeconds.load(std::memory_order_relaxed);
+    stats.aheadFrames = decodeAheadFrames();
+    stats.underProvisioned = underProvisioned.load(std::memory_order_relaxed);
+    stats.seekRole = seekRoleActive.load(std::memory_order_relaxed);
+    stats.roleSwitches = roleSwitches.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Map a decoder timestamp (stream time base) to a frame index
+int VideoPlayer::frameIndexForTimestamp(int64_t timestamp) const {
+    AVStream* stream = formatContext->streams[videoStreamIndex];
+    int64_t startTime = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+    double seconds = (double)(timestamp - startTime) * av_q2d(stream->time_base);
+    return (int)std::llround(seconds * fps);
+}
+
+// Convert a decoded frame to a cacheable VideoFrame: RGB24, or its own
+// planes for high-bit-depth YUV
+VideoFrame VideoPlayer::convertFrame(const AVFrame* frame) {
+    if (highBitDepth && isHighBitDepthYuv((AVPixelFormat)frame->format)) {
+        return copyPlanes(frame);
+    }
+
+    VideoFrame vf;
+    vf.width = width;
+    vf.height = height;
+    vf.linesize = width * 3;
+    vf.data.resize((size_t)vf.linesize * height);
+
+    uint8_t* dest[1] = { vf.data.data() };
+    int destLinesize[1] = { vf.linesize };
+
+    const uint8_t* source[4];
+    region.cropPlanes(frame, source);
+    sws_scale(scalers.get(width, height, (AVPixelFormat)frame->format),
+             source, frame->linesize, 0, height,
+             dest, destLinesize);
+    return vf;
+}
 
+void VideoPlayer::applyRegion() {
+    sourceWidth = width;
+    sourceHeight = height;
+    region = regionOfInterest.resolve(sourceWidth, sourceHeight);
+    width = region.width;
+    height = region.height;
+    if (regionOfInterest.isSet()) {
+        DEBUG_PRINT("Region of interest: " << width << "x" << height << " at " << region.x << "," << region.y
+                    << " of " << sourceWidth << "x" << sourceHeight);
+    }
+}
+
+// Keep the decoder's 16-bit planes as they are: a plain copy instead of a
+// dithering sws_scale, and 3 bytes per pixel for 4:2:0 rather than RGB48's 6
+VideoFrame VideoPlayer::copyPlanes(const AVFrame* frame) {
+    AVPixelFormat format = (AVPixelFormat)frame->format;
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+
+    VideoFrame vf;
+    vf.width = width;
+    vf.height = height;
+    vf.format = VideoFrame::YUV16;
+    vf.planeCount = av_pix_fmt_count_planes(format);
+    vf.colorSpace = frame->colorspace;
+    vf.fullRange = frame->color_range == AVCOL_RANGE_JPEG;
+
+    // Samples sit in 16-bit words shifted up by comp.shift (6 for P010)
+    int depth = desc->comp[0].depth;
+    vf.sampleScale = 65535.0f / (float)(((1 << depth) - 1) << desc->comp[0].shift);
+    vf.bitDepth = depth;
+
+    int chromaWidth = -((-width) >> desc->log2_chroma_w);
+    int chromaHeight = -((-height) >> desc->log2_chroma_h);
+    size_t offset = 0;
+    for (int plane = 0; plane < vf.planeCount; plane++) {
+        VideoFrame::Plane& layout = vf.planes[plane];
+        layout.width = plane ? chromaWidth : width;
+        layout.height = plane ? chromaHeight : height;
+        int samplesPerTexel = (plane && vf.planeCount == 2) ? 2 : 1;
+        layout.linesize = layout.width * samplesPerTexel * 2;
+        layout.offset = offset;
+        offset += (size_t)layout.linesize * layout.height;
+    }
+    vf.linesize = vf.planes[0].linesize;
+    vf.data.resize(offset);
+
+    const uint8_t* source[4];
+    region.cropPlanes(frame, source);
+    for (int plane = 0; plane < vf.planeCount; plane++) {
+        const VideoFrame::Plane& layout = vf.planes[plane];
+        av_image_copy_plane(vf.data.data() + layout.offset, layout.linesize,
+                            source[plane], frame->linesize[plane], layout.linesize, layout.height);
+    }
+    return vf;
+}
+
+// Size of one cached frame decoded as decodedFormat
+size_t VideoPlayer::cachedFrameBytes(AVPixelFormat decodedFormat) const {
+    if (highBitDepth && isHighBitDepthYuv(decodedFormat)) {
+        return (size_t)av_image_get_buffer_size(decodedFormat, width, height, 1);
+    }
+    return (size_t)width * height * 3;
+}
+
+// Decide whether the decoder has fallen behind the playhead and escalate or
+// relax the catch-up level. Runs on the decoder thread; the codec discard
+// settings themselves are applied under decoderMutex by applyCatchUpLevel().
+void VideoPlayer::updateCatchUp(int leadFrames, int decodeAhead) {
+    auto now = std::chrono::steady_clock::now();
+    int level = catchUpLevel.load(std::memory_order_relaxed);
+
+    // Paused: nothing has a deadline, decode at full quality
+    if (!playing) {
+        behindSince = aheadSince = std::chrono::steady_clock::time_point{};
+        if (level != CATCH_UP_NONE) setCatchUpLevel(CATCH_UP_NONE, "paused");
+        return;
+    }
+
+    if (leadFrames <= 0) {
+        // The playhead has caught up with (or passed) the decoder
+        aheadSince = std::chrono::steady_clock::time_point{};
+        if (behindSince == std::chrono::steady_clock::time_point{}) {
+            behindSince = now;
+        } else if (now - behindSince >= CATCH_UP_ESCALATE_AFTER && level < CATCH_UP_KEYFRAMES_ONLY) {
+            setCatchUpLevel(level + 1, "decoder behind playhead");
+            behindSince = now;
+        }
+    } else if (leadFrames >= decodeAhead / 2) {
+        // Comfortably ahead - step quality back up one level at a time
+        behindSince = std::chrono::steady_clock::time_point{};
+        if (aheadSince == std::chrono::steady_clock::time_point{}) {
+            aheadSince = now;
+        } else if (now - aheadSince >= CATCH_UP_RECOVER_AFTER && level > CATCH_UP_NONE) {
+            setCatchUpLevel(level - 1, "decoder ahead again");
+            aheadSince = now;
+        }
+    } else {
+        behindSince = aheadSince = std::chrono::steady_clock::time_point{};
+    }
+}
+
+void VideoPlayer::setCatchUpLevel(int level, const char* reason) {
+    static const char* LEVEL_NAMES[] = {
+        "full quality", "drop non-reference frames", "+ skip loop filter",
+        "+ skip IDCT on non-key frames", "keyframes only"
+    };
+    int previous = catchUpLevel.exchange(level);
+    if (level > previous) {
+        catchUpEscalations[level].fetch_add(1, std::memory_order_relaxed);
+    }
+    DEBUG_PRINT("Catch-up level " << previous << " -> " << level << " ("
+                << LEVEL_NAMES[level] << "): " << reason);
+}
+
+// Must be called with decoderMutex locked
+void VideoPlayer::applyCatchUpLevel() {
+    int level = catchUpLevel.load(std::memory_order_relaxed);
+    if (level == appliedCatchUpLevel) return;
+    appliedCatchUpLevel = level;
+
+    for (AVCodecContext* context : { codecContext, seekCodecContext }) {
+        context->skip_frame = AVDISCARD_DEFAULT;
+        context->skip_loop_filter = AVDISCARD_DEFAULT;
+        context->skip_idct = AVDISCARD_DEFAULT;
+
+        if (level >= CATCH_UP_DROP_NONREF) context->skip_frame = AVDISCARD_NONREF;
+        if (level >= CATCH_UP_SKIP_LOOP_FILTER) context->skip_loop_filter = AVDISCARD_ALL;
+        if (level >= CATCH_UP_SKIP_IDCT) context->skip_idct = AVDISCARD_NONKEY;
+        if (level >= CATCH_UP_KEYFRAMES_ONLY) context->skip_frame = AVDISCARD_NONKEY;
+    }
+}
+
+VideoPlayer::CatchUpStats VideoPlayer::getCatchUpStats() const {
+    CatchUpStats stats;
+    stats.level = catchUpLevel.load(std::memory_order_relaxed);
+    for (int level = 0; level <= CATCH_UP_KEYFRAMES_ONLY; level++) {
+        stats.escalations[level] = catchUpEscalations[level].load(std::memory_order_relaxed);
+    }
+    stats.framesSkippedBehind = framesSkippedBehind.load(std::memory_order_relaxed);
+    stats.staleFramesServed = staleFramesServed.load(std::memory_order_relaxed);
+    stats.thumbnailsServed = thumbnailsServed.load(std::memory_order_relaxed);
+    stats.missingFrames = missingFrames.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Must be called with decoderMutex locked
+void VideoPlayer::setActiveCodec(AVCodecContext* context) {
+    if (context == activeCodec) return;
+    activeCodec = context;
+    seekRoleActive.store(context == seekCodecContext, std::memory_order_relaxed);
+    roleSwitches.fetch_add(1, std::memory_order_relaxed);
+}
+
+// When the frame at frameIndex is needed on screen. Paused, nothing is due
+// soon, so decode-ahead queues behind other players' deadlines.
+FrameRequest::Clock::time_point VideoPlayer::presentationDeadline(int frameIndex) const {
+    auto now = FrameRequest::Clock::now();
+    if (!playing) return now + PAUSED_DECODE_DEADLINE;
+    int lead = frameIndex - currentFrameIndex.load(std::memory_order_relaxed);
+    return now + frameDuration * std::max(0, lead);
+}
+
+void VideoPlayer::scheduleDecodeSlice(FrameRequest::Clock::time_point deadline,
+                                      FrameRequest::Clock::time_point notBefore) {
+    // A newer token retires any slice still queued, so there is only ever one live chain
+    uint64_t token = ++decodeSliceToken;
+    DecodePool::instance().submit(this, deadline, [this, token] { runDecodeSlice(token); }, notBefore);
+}
+
+void VideoPlayer::runDecodeSlice(uint64_t token) {
+    if (shouldStopDecoder || token != decodeSliceToken.load()) return;
+
+    std::unique_lock<std::mutex> sliceLock(decodeSliceMutex, std::try_to_lock);
+    if (!sliceLock.owns_lock()) return;  // Another slice is running and will reschedule
+
+    SliceResult next = intraDecoder ? intraDecodeSlice() : decodeSlice();
+    sliceLock.unlock();
+
+    if (!shouldStopDecoder) {
+        scheduleDecodeSlice(next.deadline, next.notBefore);
+    }
+}
+
+// Convert on the pool so several frames (and players) convert in parallel.
+// Bounded, since every queued frame holds a decoder buffer.
+void VideoPlayer::submitConvert(int frameIndex, const AVFrame* frame) {
+    if (convertsInFlight.load(std::memory_order_relaxed) >= MAX_CONVERTS_IN_FLIGHT) {
+        cacheFrame(frameIndex, convertFrame(frame));
+        return;
+    }
+
+    std::shared_ptr<AVFrame> decoded(av_frame_clone(frame), [](AVFrame* f) { av_frame_free(&f); });
+    if (!decoded) {
+        cacheFrame(frameIndex, convertFrame(frame));
+        return;
+    }
+
+    convertsInFlight.fetch_add(1, std::memory_order_relaxed);
+    DecodePool::instance().submit(this, presentationDeadline(frameIndex), [this, frameIndex, decoded] {
+        cacheFrame(frameIndex, convertFrame(decoded.get()));
+        convertsInFlight.fetch_sub(1, std::memory_order_relaxed);
+    });
+}
+
+// One bounded piece of sequential decode ahead of playback (or towards the
+// earliest request). Returns when the time budget is used up or there is
+// nothing to do, saying when the next slice is due.
+VideoPlayer::SliceResult VideoPlayer::decodeSlice() {
+    DecoderState& state = decoderState;
+    auto sliceStart = std::chrono::steady_clock::now();
+
+    while (!shouldStopDecoder) {
         int currentFrame = currentFrameIndex.load(std::memory_order_relaxed);
 
-        const int DECODE_AHEAD = playing ? 50 : 10;
+        const int DECODE_AHEAD = decodeAheadFrames();
 
-        if (currentFrame < lastPlaybackFrame - 10 || currentFrame > lastPlaybackFrame + 200) {
-            sequentialFrameIndex = currentFrame - 10;
-            if (sequentialFrameIndex < 0) sequentialFrameIndex = 0;
-            needSeek = true;
+        if (currentFrame < state.lastPlaybackFrame - 10 || currentFrame > state.lastPlaybackFrame + 200) {
+            state.sequentialFrameIndex = currentFrame - 10;
+            if (state.sequentialFrameIndex < 0) state.sequentialFrameIndex = 0;
+            state.needSeek = true;
+            state.locating = true;
         }
-        lastPlaybackFrame = currentFrame;
+        state.lastPlaybackFrame = currentFrame;
 
-        if (sequentialFrameIndex > currentFrame + DECODE_AHEAD) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
-            continue;
+        updateCatchUp(state.sequentialFrameIndex - currentFrame, DECODE_AHEAD);
+
+        // Frames the playhead has already passed are of no use - don't wait for them
+        if (playing && state.sequentialFrameIndex < currentFrame) {
+            state.sequentialFrameIndex = currentFrame;
         }
 
-        // Check if already cached
+        // Earliest deadline first: an explicit request due before the next
+        // decode-ahead frame is presented takes the decoder. Targets the
+        // sequential decode will reach within a GOP are left to it.
+        FrameRequest::Clock::time_point sliceDeadline = presentationDeadline(state.sequentialFrameIndex);
+        bool serveRequest = false;
+        if (FrameRequestHandle request = nextRequest()) {
+            if (request->getDeadline() <= sliceDeadline) {
+                serveRequest = true;
+                sliceDeadline = request->getDeadline();
+                int target = request->getFrameIndex();
+                if (target != state.requestTarget) {
+                    state.requestTarget = target;
+                    state.requestLocates = 0;
+                }
+                int reach = std::max(gopFrames.load(std::memory_order_relaxed), (int)fps);
+                if (target < state.sequentialFrameIndex || target > state.sequentialFrameIndex + reach) {
+                    // Located there before and it still isn't cached: it never comes out
+                    if (++state.requestLocates > MAX_REQUEST_LOCATES) {
+                        failRequests(target, "not decoded after repeated locates");
+                        state.requestTarget = -1;
+                        continue;
+                    }
+                    state.sequentialFrameIndex = target;
+                    state.locating = true;
+                }
+            }
+        }
+
+        // Far enough ahead - look again shortly (a new request reschedules us at once)
+        if (!serveRequest && state.sequentialFrameIndex > currentFrame + DECODE_AHEAD) {
+            auto wake = FrameRequest::Clock::now() + DECODE_IDLE_POLL;
+            return {wake + frameDuration * DECODE_AHEAD, wake};
+        }
+
+        // Used our share of the pool - requeue behind anything due sooner
+        if (std::chrono::steady_clock::now() - sliceStart >= DECODE_SLICE_BUDGET) {
+            return {sliceDeadline, {}};
+        }
+
+        // Check if already cached (hot, or compressed in the cold tier)
         {
             std::lock_guard<std::mutex> lock(cacheMutex);
-            if (frameCache.find(sequentialFrameIndex) != frameCache.end()) {
-                sequentialFrameIndex++;
-                if (sequentialFrameIndex >= totalFrames) {
-                    sequentialFrameIndex = 0;
-                    needSeek = true;
+            bool cached = frameCache.find(state.sequentialFrameIndex) != frameCache.end();
+            if (!cached && coldCache && coldCache->contains(state.sequentialFrameIndex)) {
+                coldCache->requestPromote(state.sequentialFrameIndex);
+                cached = true;
+            }
+            if (cached) {
+                state.sequentialFrameIndex++;
+                if (state.sequentialFrameIndex >= totalFrames) {
+                    state.sequentialFrameIndex = 0;
+                    state.needSeek = true;
                 }
                 continue;
             }
         }
 
-        // CRITICAL FIX: Only lock during FFmpeg operations, not entire loop
-        bool frameDecoded = false;
-        {
-            std::lock_guard<std::mutex> decoderLock(decoderMutex);
-            
-            // Check shutdown flag again after acquiring lock
-            if (shouldStopDecoder) break;
-
-            // Seek if needed
-            if (needSeek) {
-                int64_t timestamp = (int64_t)(sequentialFrameIndex / fps * AV_TIME_BASE);
-                av_seek_frame(formatContext, -1, timestamp, AVSEEK_FLAG_BACKWARD);
-                avcodec_flush_buffers(codecContext);
-                needSeek = false;
-            }
+        // Skipped far past the decoder over cached frames: a seek beats decoding the gap.
+        // Moved behind it (a request, or the playhead clamp): only a seek goes back.
+        int seekGap = std::max(gopFrames.load(std::memory_order_relaxed), (int)fps);
+        if (!state.needSeek && state.decoderPosition >= 0 &&
+            (state.sequentialFrameIndex - state.decoderPosition > seekGap ||
+             state.sequentialFrameIndex <= state.decoderPosition)) {
+            state.needSeek = true;
+        }
+
+        // Only lock during FFmpeg operations
+        std::lock_guard<std::mutex> decoderLock(decoderMutex);
+
+        auto workStart = std::chrono::steady_clock::now();
+
+        applyCatchUpLevel();
+
+        // Seek if needed. A locate (or anything while paused) decodes on the
+        // seek context so the target isn't held back by frame-thread delay;
+        // plain sequential seeks while playing (loop, skipping a cached run)
+        // stay on the playback context.
+        if (state.needSeek) {
+            int64_t timestamp = (int64_t)(state.sequentialFrameIndex / fps * AV_TIME_BASE);
+            av_seek_frame(formatContext, -1, timestamp, AVSEEK_FLAG_BACKWARD);
+            setActiveCodec((playing && !state.locating) ? codecContext : seekCodecContext);
+            avcodec_flush_buffers(activeCodec);
+            // A locate rolls forward from the keyframe: keep the last few frames
+            // before the target too, for small backward scrubs
+            state.keepFrom = state.locating ? std::max(0, state.sequentialFrameIndex - SEEK_ROLL_KEEP_BEHIND) : -1;
+            state.needSeek = false;
+            state.locating = false;
+            state.decoderPosition = -1;
+            lastKeyframeIndex = -1;  // A GOP straddling the seek isn't a whole one
+        }
 
-            // Decode next frame sequentially
-            if (av_read_frame(formatContext, packet) >= 0) {
-                if (packet->stream_index == videoStreamIndex) {
-                    if (avcodec_send_packet(codecContext, packet) >= 0) {
-                        if (avcodec_receive_frame(codecContext, frame) >= 0) {
-                            // Convert to RGB24
-                            VideoFrame vf;
-                            vf.width = width;
-                            vf.height = height;
-                            vf.linesize = width * 3;
-                            vf.data.resize(numBytes);
-
-                            uint8_t* dest[1] = { vf.data.data() };
-                            int destLinesize[1] = { vf.linesize };
-
-                            sws_scale(swsContext,
-                                     frame->data, frame->linesize, 0, height,
-                                     dest, destLinesize);
-
-                            // Add to cache
-                            {
-                                std::lock_guard<std::mutex> lock(cacheMutex);
-                                frameCache[sequentialFrameIndex] = std::move(vf);
-                                cacheOrder.push_back(sequentialFrameIndex);
-                                evictOldFrames();
-                            }
-
-                            frameDecoded = true;
-
-                            sequentialFrameIndex++;
-
-                            if (sequentialFrameIndex >= totalFrames) {
-                                sequentialFrameIndex = 0;
-                                needSeek = true;
-                            }
-                        }
+        AVFrame* frame = state.frame;
+        AVPacket* packet = state.packet;
+
+        // Frames are placed by timestamp, so frames the decoder discards
+        // (catch-up) or rolls through after a seek land at the right index
+        auto receiveFrames = [&]() {
+            while (avcodec_receive_frame(activeCodec, frame) >= 0) {
+                int decodedIndex = (frame->best_effort_timestamp != AV_NOPTS_VALUE)
+                    ? frameIndexForTimestamp(frame->best_effort_timestamp)
+                    : state.decoderPosition + 1;
+                state.decoderPosition = decodedIndex;
+
+                state.pendingDecodeSeconds += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - workStart).count();
+                // The GOP is only measured while catch-up isn't discarding frames
+                int runIndex = appliedCatchUpLevel == CATCH_UP_NONE ? decodedIndex : -1;
+                recordDecodeTiming(state.pendingDecodeSeconds, runIndex, isKeyFrame(frame));
+                state.pendingDecodeSeconds = 0.0;
+                workStart = std::chrono::steady_clock::now();
+
+                if (decodedIndex >= totalFrames) continue;
+
+                // Rolling forward from the keyframe to the frame we want: cache
+                // the ones just before it, skip the rest
+                if (decodedIndex < state.sequentialFrameIndex) {
+                    int playhead = currentFrameIndex.load(std::memory_order_relaxed);
+                    if (state.keepFrom >= 0 && decodedIndex >= state.keepFrom &&
+                        !(playing && decodedIndex < playhead) && !isCached(decodedIndex)) {
+                        submitConvert(decodedIndex, frame);
                     }
+                    continue;
+                }
+
+                // Heading for a requested frame and the decoder stepped over it
+                // (dropped by catch-up, a timestamp gap): decoding again won't help
+                if (state.requestTarget >= state.sequentialFrameIndex && decodedIndex >= state.requestTarget) {
+                    if (decodedIndex > state.requestTarget) {
+                        failRequests(state.requestTarget, "skipped by the decoder");
+                    }
+                    state.requestTarget = -1;
+                }
+
+                // Already behind the playhead: skip the RGB conversion (unless someone asked for it)
+                int playhead = currentFrameIndex.load(std::memory_order_relaxed);
+                if (playing && decodedIndex < playhead && !isRequested(decodedIndex)) {
+                    framesSkippedBehind.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    submitConvert(decodedIndex, frame);
+                }
+
+                state.sequentialFrameIndex = decodedIndex + 1;
+                if (state.sequentialFrameIndex >= totalFrames) {
+                    state.sequentialFrameIndex = 0;
+                    state.needSeek = true;
                 }
-                av_packet_unref(packet);
-            } else {
-                // EOF - wrap to beginning
-                sequentialFrameIndex = 0;
-                needSeek = true;
             }
-        }  // decoderLock released here
+        };
+
+        // Decode next packet
+        if (av_read_frame(formatContext, packet) >= 0) {
+            if (packet->stream_index == videoStreamIndex) {
+                bool keyPacket = packet->flags & AV_PKT_FLAG_KEY;
+
+                // Playing on from a locate: hand over to the frame-threaded
+                // context at the next closed GOP, draining the seek context
+                // first. At an open-GOP keyframe the fresh context would lose
+                // the leading pictures, so the seek context carries on to the next one.
+                if (keyPacket && playing && activeCodec == seekCodecContext && seekCodecContext != codecContext &&
+                    GopBoundary::isClosed(packet, formatContext->streams[videoStreamIndex]->codecpar)) {
+                    if (avcodec_send_packet(seekCodecContext, nullptr) >= 0) {
+                        receiveFrames();
+                    }
+                    avcodec_flush_buffers(seekCodecContext);
+                    setActiveCodec(codecContext);
+                    avcodec_flush_buffers(codecContext);
+                }
 
-        if (!frameDecoded) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if (avcodec_send_packet(activeCodec, packet) >= 0) {
+                    receiveFrames();
+                }
+            }
+            av_packet_unref(packet);
+
+            state.pendingDecodeSeconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - workStart).count();
+        } else {
+            // EOF - drain frames still held by the decoder (reordering delay), then wrap
+            if (avcodec_send_packet(activeCodec, nullptr) >= 0) {
+                receiveFrames();
+            }
+            // The real last frame, unless catch-up dropped the tail
+            if (state.decoderPosition >= 0 && appliedCatchUpLevel == CATCH_UP_NONE) {
+                lastStreamFrame.store(state.decoderPosition, std::memory_order_relaxed);
+            }
+            // A requested frame still ahead is past the end of the stream
+            if (state.requestTarget >= state.sequentialFrameIndex) {
+                failRequests(state.requestTarget, "past the end of the stream");
+                state.requestTarget = -1;
+            }
+            state.sequentialFrameIndex = 0;
+            state.needSeek = true;
         }
+    }
+
+    return {FrameRequest::Clock::now(), {}};
+}
 
-        // Check shutdown flag frequently
-        if (shouldStopDecoder) break;
+// All-intra sources: no sequential decoder at all. Every frame the playhead
+// will need, and every request, becomes its own pool job decoded on an
+// independent context, so frames finish in any order on every core.
+VideoPlayer::SliceResult VideoPlayer::intraDecodeSlice() {
+    int currentFrame = currentFrameIndex.load(std::memory_order_relaxed);
+    int decodeAhead = decodeAheadFrames();
+    size_t maxInFlight = (size_t)DecodePool::instance().getThreadCount() * 2;
+    bool saturated = false;
+
+    // A locate: frames that failed before get another chance straight away
+    if (intraPlayhead >= 0 && std::abs(currentFrame - intraPlayhead) > decodeAhead) {
+        std::lock_guard<std::mutex> lock(intraMutex);
+        intraFailed.clear();
     }
+    intraPlayhead = currentFrame;
 
-    av_frame_free(&frame);
-    av_packet_free(&packet);
+    // Requests first - they're already in deadline order
+    for (const auto& request : pendingRequestFrames()) {
+        if (!submitIntraDecode(request.second, request.first, maxInFlight)) {
+            saturated = true;
+            break;
+        }
+    }
+
+    // Then the window around the playhead, nearest first. Playing: everything
+    // ahead, then a few frames behind for small scrubs. Paused: alternate
+    // either side, since a step or scrub can go both ways.
+    std::vector<int> offsets;
+    if (playing) {
+        for (int offset = 0; offset <= decodeAhead; offset++) offsets.push_back(offset);
+        for (int offset = 1; offset <= SEEK_ROLL_KEEP_BEHIND; offset++) offsets.push_back(-offset);
+    } else {
+        offsets.push_back(0);
+        for (int offset = 1; offset <= decodeAhead; offset++) {
+            offsets.push_back(offset);
+            offsets.push_back(-offset);
+        }
+    }
+
+    int firstNotSubmitted = -1;
+    for (int offset : offsets) {
+        // Ahead wraps round to the start for looping; behind stops at frame 0
+        if (std::abs(offset) >= totalFrames || currentFrame + offset < 0) continue;
+        int frameIndex = (currentFrame + offset) % totalFrames;
+        // Frames behind the playhead are only a convenience - due after the window
+        int lead = (offset >= 0) ? offset : decodeAhead - offset;
+        if (!submitIntraDecode(frameIndex, presentationDeadline(currentFrame + lead), maxInFlight)) {
+            saturated = true;
+            firstNotSubmitted = frameIndex;
+            break;
+        }
+    }
+
+    // Image files: get the kernel reading the frames we couldn't queue yet
+    if (saturated && firstNotSubmitted >= 0 && playing) {
+        intraDecoder->readahead(firstNotSubmitted, (int)maxInFlight);
+    }
 
-    DEBUG_PRINT("Background decoder thread stopped");
+    // Saturated: top up again as soon as jobs finish; otherwise idle-poll
+    auto now = FrameRequest::Clock::now();
+    auto wake = now + (saturated ? std::chrono::milliseconds(2) : DECODE_IDLE_POLL);
+    return {presentationDeadline(currentFrame + decodeAhead), wake};
+}
+
+// Queue one intra frame decode unless it's cached or already on its way.
+// Returns false once maxInFlight decodes are outstanding.
+bool VideoPlayer::submitIntraDecode(int frameIndex, FrameRequest::Clock::time_point deadline, size_t maxInFlight) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (frameCache.find(frameIndex) != frameCache.end()) return true;
+        if (coldCache && coldCache->contains(frameIndex)) {
+            coldCache->requestPromote(frameIndex);
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(intraMutex);
+        if (intraInFlight.count(frameIndex)) return true;
+        auto failed = intraFailed.find(frameIndex);
+        if (failed != intraFailed.end()) {
+            if (std::chrono::steady_clock::now() - failed->second < INTRA_RETRY_AFTER) return true;
+            intraFailed.erase(failed);
+        }
+        if (intraInFlight.size() >= maxInFlight) return false;
+        intraInFlight.insert(frameIndex);
+    }
+
+    DecodePool::instance().submit(this, deadline, [this, frameIndex] {
+        auto start = std::chrono::steady_clock::now();
+        bool converted = false;
+        int landedAt = -1;
+        intraDecoder->decode(frameIndex, [this, &converted, &landedAt](int decodedIndex, const AVFrame* decoded) {
+            landedAt = decodedIndex;
+            if (decodedIndex >= 0 && decodedIndex < totalFrames) {
+                converted = cacheIntraFrame(decodedIndex, decoded);
+            }
+        });
+        // The seek landed past it (no frame with that timestamp, or an inexact
+        // index): the picture is cached where it belongs, and this index is
+        // given up for now rather than resubmitted every slice
+        if (landedAt != frameIndex) {
+            converted = false;
+        }
+        if (!converted) {
+            failRequests(frameIndex, landedAt < 0 ? "unreadable"
+                                     : landedAt != frameIndex ? "seek landed on another frame" : "wrong size");
+        }
+
+        // Frames decode side by side, so real-time load is per-frame cost over the workers
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        {
+            std::lock_guard<std::mutex> lock(timingMutex);
+            gopFrames.store(1, std::memory_order_relaxed);  // Every frame is a keyframe
+            recordDecodeTiming(seconds / DecodePool::instance().getThreadCount(), -1, true);
+        }
+
+        std::lock_guard<std::mutex> lock(intraMutex);
+        intraInFlight.erase(frameIndex);
+        if (!converted) {
+            intraFailed[frameIndex] = std::chrono::steady_clock::now();  // Don't retry it every slice
+        }
+    });
+    return true;
+}
+
+// Sequence frames can differ from the first image in pixel format (handled by
+// the per-thread scalers) but not in size
+bool VideoPlayer::cacheIntraFrame(int frameIndex, const AVFrame* frame) {
+    if (frame->width != sourceWidth || frame->height != sourceHeight) {
+        DEBUG_PRINT("Frame " << frameIndex << " is " << frame->width << "x" << frame->height
+                    << ", expected " << sourceWidth << "x" << sourceHeight << " - skipped");
+        return false;
+    }
+    cacheFrame(frameIndex, convertFrame(frame));
+    return true;
 }
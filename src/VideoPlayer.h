@@ -9,6 +9,9 @@
 #include <thread>
 #include <mutex>
 #include <list>
+#include <map>
+#include <unordered_set>
+#include <cstddef>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -17,18 +20,89 @@ extern "C" {
 #include <libswscale/swscale.h>
 }
 
-struct VideoFrame {
-    std::vector<uint8_t> data;  // RGB24 pixel data
-    int width;
-    int height;
-    int linesize;
-};
+#include "VideoFrame.h"
+#include "FrameRegion.h"
+#include "ColdFrameCache.h"
+#include "ThumbnailIndex.h"
+#include "FrameRequest.h"
+#include "DecodePool.h"
+#include "IntraFrameDecoder.h"
+#include "RawFrameSource.h"
 
 class VideoPlayer {
 public:
     VideoPlayer() = default;
     ~VideoPlayer();
 
+    // Compressed second cache tier behind the decoded frames (0 = disabled).
+    // Must be set before loadVideo().
+    void setColdCacheBudget(size_t bytes) { coldCacheBudgetBytes = bytes; }
+
+    // Pre-fault (and mlock) frame buffers in FrameMemory once the frame size is
+    // known. Must be set before loadVideo(); see FrameMemory::configure().
+    void setReserveFrameMemory(bool reserve) { reserveFrameMemory = reserve; }
+
+    // Build a keyframe thumbnail index in the background and show the nearest
+    // thumbnail while a locate target is still decoding. Must be set before loadVideo().
+    void setThumbnails(bool enabled, const ThumbnailIndex::Options& options) {
+        thumbnailsEnabled = enabled;
+        thumbnailOptions = options;
+    }
+
+    // Codec threading per decoder role. Frame threading has the best
+    // throughput but holds back about thread_count frames, which every locate
+    // pays for; slice threading adds no delay. The sequential decoder uses the
+    // seek role after a locate or while paused and hands over to the playback
+    // role at the next keyframe once playing.
+    struct CodecThreading {
+        int threadType = FF_THREAD_FRAME;  // FF_THREAD_FRAME and/or FF_THREAD_SLICE
+        int threadCount = 0;               // 0 = this player's share of the DecodePool
+    };
+    // mode: "frame", "slice", "frame+slice" (or "auto"), "none"
+    static CodecThreading parseCodecThreading(const std::string& mode, int threads);
+    // Must be set before loadVideo()
+    void setCodecThreading(const CodecThreading& playback, const CodecThreading& seek) {
+        playbackThreading = playback;
+        seekThreading = seek;
+    }
+
+    // Decode all-intra sources (ProRes, DNxHR, MJPEG, ...) frame by frame in
+    // parallel instead of through the sequential decoder. Must be set before loadVideo().
+    void setIntraFastPath(bool enabled) { intraFastPath = enabled; }
+
+    // Frame rate for image-sequence sources (a directory or a %04d pattern),
+    // which carry none of their own. Must be set before loadVideo().
+    void setSequenceFrameRate(double rate) { sequenceFrameRate = rate; }
+
+    // Raw frame input (loadVideo() with "-", "pipe:", "shm:" or "memfd:"):
+    // frames are stamped with the playhead position when they arrive, on a
+    // timeline of frameRate. latestOnly skips the cache and always shows the
+    // newest frame. Must be set before loadVideo().
+    void setRawInput(const RawFrameSource::Options& options, double frameRate) {
+        rawOptions = options;
+        rawFrameRate = frameRate;
+    }
+
+    // Cache 10/12-bit YUV frames as their 16-bit planes (VideoFrame::YUV16)
+    // instead of dithering them down to RGB24 - needs the shader renderer.
+    // Must be set before loadVideo().
+    void setHighBitDepth(bool enabled) { highBitDepth = enabled; }
+
+    // Which of the file's video streams to play (0 = the first). Multi-angle
+    // files play each stream on its own player. Must be set before loadVideo().
+    void setVideoStream(int number) { videoStreamNumber = number; }
+    int getVideoStream() const { return videoStreamNumber; }
+    static int countVideoStreams(const std::string& filePath);
+
+    // Interlaced sources report their field order (codec/container flag);
+    // the render path deinterlaces them. Valid after loadVideo().
+    enum class FieldOrder { Progressive, TopFirst, BottomFirst };
+    FieldOrder getFieldOrder() const { return fieldOrder; }
+
+    // Fraction of the hot and cold cache budgets this player gets when
+    // several share the memory (e.g. 1/N for N streams). Must be set before loadVideo().
+    void setCacheShare(double share);
+
     // Load and decode entire video into RAM
     bool loadVideo(const std::string& filePath);
 
@@ -41,8 +115,29 @@ public:
     // Sync to external audio clock (preferred method - drift-free)
     void syncToTimestamp(double audioTimestamp);
 
-    // Get current frame for rendering
-    const VideoFrame* getCurrentFrame();
+    // Get current frame for rendering (shared so eviction can't free it mid-upload)
+    std::shared_ptr<const VideoFrame> getCurrentFrame();
+
+    // Ask for a specific frame by a deadline. Served from cache when possible,
+    // otherwise queued for the decode engine, which works on whichever is due
+    // first: the earliest request or the next decode-ahead frame. Raw input
+    // has nothing to decode, so a request it can't serve from cache fails.
+    FrameRequestHandle requestFrame(int frameIndex, FrameRequest::Clock::time_point deadline);
+
+    // A hot-cached frame or nullptr - never schedules a decode (deinterlacer neighbours)
+    std::shared_ptr<const VideoFrame> peekFrame(int frameIndex) const;
+
+    struct RequestStats {
+        uint64_t submitted = 0;
+        uint64_t fromCache = 0;   // Fulfilled immediately
+        uint64_t met = 0;         // Fulfilled by the decode engine before the deadline
+        uint64_t missed = 0;      // Fulfilled late
+        uint64_t cancelled = 0;
+        uint64_t failed = 0;      // Never came out of the decoder
+        double worstLateMs = 0.0;
+        size_t pending = 0;
+    };
+    RequestStats getRequestStats() const;
 
     // Update playback position (call regularly) - fallback timer-based method
     void update();
@@ -58,17 +153,79 @@ public:
     double getDuration() const { return duration; }
     int getCurrentFrameIndex() const { return currentFrameIndex.load(std::memory_order_relaxed); }
 
+    struct CacheStats {
+        size_t hotFrames = 0;
+        size_t hotLimit = 0;
+        size_t coldFrames = 0;
+        size_t coldBytes = 0;
+        uint64_t dedupFrames = 0;      // Frames that reused an identical cached buffer
+        uint64_t dedupBytesSaved = 0;  // Bytes not allocated thanks to that
+    };
+    CacheStats getCacheStats() const;
+
+    bool isRawInput() const { return rawSource != nullptr; }
+    RawFrameSource::Stats getRawInputStats() const;
+
+    // Decode-ahead window, sized from measured decode cost (see recordDecodeTiming)
+    struct DecodeStats {
+        double avgFrameMs = 0.0;
+        double peakFrameMs = 0.0;
+        int gopFrames = 0;             // Last observed keyframe distance
+        double load = 0.0;             // Decode time / real time; >= 1 can't keep up
+        double aheadSeconds = 0.0;
+        int aheadFrames = 0;
+        bool underProvisioned = false;
+        bool seekRole = false;         // Sequential decoder currently on the seek context
+        uint64_t roleSwitches = 0;
+    };
+    DecodeStats getDecodeStats() const;
+
+    // Catch-up policy when decode falls behind playback: each level adds a
+    // cheaper decode mode, stepped back down once the decoder is ahead again
+    enum CatchUpLevel {
+        CATCH_UP_NONE = 0,
+        CATCH_UP_DROP_NONREF,       // skip_frame = AVDISCARD_NONREF
+        CATCH_UP_SKIP_LOOP_FILTER,  // + skip_loop_filter = AVDISCARD_ALL
+        CATCH_UP_SKIP_IDCT,         // + skip_idct = AVDISCARD_NONKEY
+        CATCH_UP_KEYFRAMES_ONLY     // skip_frame = AVDISCARD_NONKEY
+    };
+    struct CatchUpStats {
+        int level = CATCH_UP_NONE;
+        uint64_t escalations[CATCH_UP_KEYFRAMES_ONLY + 1] = {};  // Times each level was entered
+        uint64_t framesSkippedBehind = 0;  // Decoded after the playhead passed - not converted
+        uint64_t staleFramesServed = 0;    // getCurrentFrame() returned a neighbouring frame
+        uint64_t thumbnailsServed = 0;     // getCurrentFrame() fell back to a keyframe thumbnail
+        uint64_t missingFrames = 0;        // getCurrentFrame() had nothing to return
+    };
+    CatchUpStats getCatchUpStats() const;
+
+    // Keep only part of each frame (a video wall node's tile): conversion,
+    // the caches, thumbnails and uploads cover just that rectangle, and
+    // getWidth()/getHeight() report its size. Not for raw input. Must be set
+    // before loadVideo().
+    void setRegionOfInterest(const RegionOfInterest& region) { regionOfInterest = region; }
+
+    // Scale hot and cold cache budgets (1.0 = configured size), e.g. from
+    // MemoryPressureMonitor. Shrinking evicts through the normal LRU policy.
+    void setCacheBudgetScale(double scale, const std::string& reason);
+
 private:
     bool loaded = false;
     std::atomic<bool> playing{false};
     std::string errorMessage;
 
-    // Video metadata
+    // Video metadata. width/height: the cached frames (the region of interest);
+    // sourceWidth/sourceHeight: the decoded ones.
     int width = 0;
     int height = 0;
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    RegionOfInterest regionOfInterest;
+    FrameRegion region;
     double fps = 0.0;
     double duration = 0.0;
     int totalFrames = 0;
+    FieldOrder fieldOrder = FieldOrder::Progressive;
 
     // Playback state
     std::atomic<int> currentFrameIndex{0};
@@ -81,28 +238,187 @@ private:
 
     // Frame cache (ring buffer) - on-demand decoding
     static constexpr size_t MAX_CACHED_FRAMES = 300;  // ~600MB for 720p
-    std::unordered_map<int, VideoFrame> frameCache;
+    static constexpr size_t MIN_CACHED_FRAMES = 60;   // Floor under memory pressure (> decode-ahead)
+    std::atomic<size_t> maxCachedFrames{MAX_CACHED_FRAMES};
+    double cacheShare = 1.0;
+    std::unordered_map<int, std::shared_ptr<const VideoFrame>> frameCache;
     std::list<int> cacheOrder;  // LRU tracking
     mutable std::mutex cacheMutex;
 
+    // Content dedup: identical frames (static holds, black) share one buffer
+    std::unordered_map<uint64_t, std::weak_ptr<const VideoFrame>> hashIndex;
+    uint64_t dedupFrames = 0;
+    uint64_t dedupBytesSaved = 0;
+
+    // Cold tier: frames evicted above are compressed here instead of dropped
+    static constexpr size_t DEFAULT_COLD_CACHE_BYTES = 1024ull * 1024 * 1024;
+    size_t coldCacheBudgetBytes = DEFAULT_COLD_CACHE_BYTES;
+    std::unique_ptr<ColdFrameCache> coldCache;
+
+    // Low-res stand-ins for frames that are far from anything cached
+    bool thumbnailsEnabled = true;
+    ThumbnailIndex::Options thumbnailOptions;
+    std::unique_ptr<ThumbnailIndex> thumbnails;
+
+    bool highBitDepth = false;
+
+    // Buffers in flight beyond the hot cache: decode, cold-tier queue, renderer
+    static constexpr size_t FRAME_POOL_HEADROOM = 48;
+    bool reserveFrameMemory = false;
+
+    // Outstanding frame requests, earliest deadline first
+    mutable std::mutex requestMutex;
+    std::multimap<FrameRequest::Clock::time_point, FrameRequestHandle> pendingRequests;
+    FrameRequestHandle renderRequest;  // getCurrentFrame()'s request for the playhead frame (render thread)
+    std::atomic<uint64_t> requestsSubmitted{0};
+    std::atomic<uint64_t> requestsFromCache{0};
+    std::atomic<uint64_t> requestsMet{0};
+    std::atomic<uint64_t> requestsMissed{0};
+    std::atomic<uint64_t> requestsCancelled{0};
+    std::atomic<uint64_t> requestsFailed{0};
+    // Last frame index the demuxer really has - found at EOF, as totalFrames
+    // (duration * fps) can overestimate. -1 = not known yet.
+    std::atomic<int> lastStreamFrame{-1};
+    double worstLateSeconds = 0.0;  // Under requestMutex
+
     // FFmpeg decoder mutex (FFmpeg contexts are NOT thread-safe)
     std::mutex decoderMutex;
 
+    // Frames before a seek target still worth caching (small backward scrubs)
+    static constexpr int SEEK_ROLL_KEEP_BEHIND = 10;
+
     // FFmpeg contexts (kept open for on-demand decoding)
     AVFormatContext* formatContext = nullptr;
-    AVCodecContext* codecContext = nullptr;
-    SwsContext* swsContext = nullptr;
+    AVCodecContext* codecContext = nullptr;      // Playback role
+    AVCodecContext* seekCodecContext = nullptr;  // Seek/scrub role
+    AVCodecContext* activeCodec = nullptr;       // The one the sequential decoder feeds (under decoderMutex)
+    CodecThreading playbackThreading{FF_THREAD_FRAME, 0};
+    CodecThreading seekThreading{FF_THREAD_SLICE, 0};
+    std::atomic<bool> seekRoleActive{false};
+    std::atomic<uint64_t> roleSwitches{0};
     int videoStreamIndex = -1;
+    int videoStreamNumber = 0;  // Among the video streams only
+
+    // Decoder: a self-rescheduling job on the shared DecodePool. Each slice
+    // decodes for at most DECODE_SLICE_BUDGET, then requeues at the deadline
+    // of the next frame it needs; converts run as separate pool jobs.
+    struct DecoderState {
+        AVPacket* packet = nullptr;
+        AVFrame* frame = nullptr;
+        int sequentialFrameIndex = 0;  // Next frame we want in the cache
+        int decoderPosition = -1;      // Index of the last frame out of the decoder (-1 = just seeked)
+        bool needSeek = true;
+        int lastPlaybackFrame = 0;
+        double pendingDecodeSeconds = 0.0;  // Work spent on packets that haven't produced a frame yet
+        bool locating = false;  // The pending seek is a locate, not sequential playback
+        int keepFrom = -1;      // Roll-forward frames from here on are cached (-1 = none)
+        int requestTarget = -1;    // Frame of the request being served (-1 = none)
+        int requestLocates = 0;    // Locates made towards it
+    };
+    struct SliceResult {
+        FrameRequest::Clock::time_point deadline;
+        FrameRequest::Clock::time_point notBefore;
+    };
+    static constexpr std::chrono::milliseconds DECODE_SLICE_BUDGET{4};
+    static constexpr std::chrono::milliseconds DECODE_IDLE_POLL{20};
+    static constexpr std::chrono::seconds PAUSED_DECODE_DEADLINE{1};
+    static constexpr int MAX_CONVERTS_IN_FLIGHT = 8;
+    static constexpr int MAX_REQUEST_LOCATES = 3;  // Then the request fails instead of looping
+    // All-intra fast path: replaces the sequential decoder when set
+    bool intraFastPath = true;
+    double sequenceFrameRate = 25.0;
+    std::unique_ptr<IntraFrameDecoder> intraDecoder;
+    std::mutex intraMutex;
+    std::unordered_set<int> intraInFlight;  // Under intraMutex
+    // Frames that wouldn't decode, and when. Not retried every slice, but again
+    // after INTRA_RETRY_AFTER or a locate (an image still being copied in).
+    std::unordered_map<int, std::chrono::steady_clock::time_point> intraFailed;  // Under intraMutex
+    static constexpr std::chrono::seconds INTRA_RETRY_AFTER{2};
+    int intraPlayhead = -1;                 // At the last intra slice (running slice only)
+    std::mutex timingMutex;                 // recordDecodeTiming() from several intra jobs at once
 
-    // Background decoder thread
-    std::thread decoderThread;
+    // Raw frame input: replaces demuxing and decoding altogether
+    static constexpr double RAW_TIMELINE_SECONDS = 24 * 3600.0;
+    RawFrameSource::Options rawOptions;
+    double rawFrameRate = 60.0;
+    std::unique_ptr<RawFrameSource> rawSource;
+    mutable std::mutex latestMutex;
+    std::shared_ptr<const VideoFrame> latestFrame;  // latestOnly: the newest arrival, under latestMutex
+
+    DecoderState decoderState;       // Only touched by the running slice
+    std::mutex decodeSliceMutex;     // Held by the running slice
+    std::atomic<uint64_t> decodeSliceToken{0};
     std::atomic<bool> shouldStopDecoder{false};
+    std::atomic<int> convertsInFlight{0};
+    bool decodePoolClient = false;
     std::atomic<int> lastDecodedFrame{-1};
 
+    // Decode-ahead sizing: written by the decoder thread, read by anyone
+    static constexpr double MIN_DECODE_AHEAD_SECONDS = 0.5;
+    static constexpr double DECODE_AHEAD_SAFETY = 2.0;      // Multiple of the worst spike to keep buffered
+    static constexpr double MAX_DECODE_AHEAD_CACHE_SHARE = 0.6;  // Leave the rest for frames behind the playhead
+    static constexpr double UNDER_PROVISIONED_LOAD = 0.9;
+    static constexpr double DECODE_TIME_EMA_ALPHA = 0.05;
+    static constexpr double PEAK_DECAY = 0.995;             // Per frame, so old spikes fade after a few GOPs
+    std::atomic<double> avgDecodeSeconds{0.0};
+    std::atomic<double> peakDecodeSeconds{0.0};
+    std::atomic<int> gopFrames{0};
+    std::atomic<double> decodeAheadSeconds{MIN_DECODE_AHEAD_SECONDS};
+    std::atomic<bool> underProvisioned{false};
+    int lastKeyframeIndex = -1;  // Decoder thread only; -1 = no unbroken run since a seek
+
+    // Catch-up state
+    static constexpr std::chrono::milliseconds CATCH_UP_ESCALATE_AFTER{250};
+    static constexpr std::chrono::milliseconds CATCH_UP_RECOVER_AFTER{1000};
+    std::atomic<int> catchUpLevel{CATCH_UP_NONE};
+    int appliedCatchUpLevel = CATCH_UP_NONE;  // Under decoderMutex
+    std::chrono::steady_clock::time_point behindSince;  // Decoder thread only
+    std::chrono::steady_clock::time_point aheadSince;
+    std::atomic<uint64_t> catchUpEscalations[CATCH_UP_KEYFRAMES_ONLY + 1] = {};
+    std::atomic<uint64_t> framesSkippedBehind{0};
+    std::atomic<uint64_t> staleFramesServed{0};
+    std::atomic<uint64_t> thumbnailsServed{0};
+    std::atomic<uint64_t> missingFrames{0};
+
     // Private methods
+    // frameIndex: the frame's index in an unbroken decode run, or -1 (after a
+    // seek, while catch-up discards frames, intra jobs) to not measure the GOP
+    void recordDecodeTiming(double frameSeconds, int frameIndex, bool keyframe);
+    void updateCatchUp(int leadFrames, int decodeAhead);
+    void setCatchUpLevel(int level, const char* reason);
+    void applyCatchUpLevel();
+    int frameIndexForTimestamp(int64_t timestamp) const;
+    void applyRegion();  // width/height known: narrow them to the region of interest
+    VideoFrame convertFrame(const AVFrame* frame);
+    VideoFrame copyPlanes(const AVFrame* frame);
+    size_t cachedFrameBytes(AVPixelFormat decodedFormat) const;
+    int decodeAheadFrames() const;
     bool decodeFrame(int frameIndex);
     void ensureFrameLoaded(int frameIndex);
-    void backgroundDecoderTask();
+    AVCodecContext* openCodecContext(const AVCodec* codec, const AVCodecParameters* codecParams,
+                                     const CodecThreading& threading);
+    static const char* threadingName(const AVCodecContext* context);
+    void setActiveCodec(AVCodecContext* context);
+    FrameRequest::Clock::time_point presentationDeadline(int frameIndex) const;
+    void scheduleDecodeSlice(FrameRequest::Clock::time_point deadline,
+                             FrameRequest::Clock::time_point notBefore = FrameRequest::Clock::time_point{});
+    void runDecodeSlice(uint64_t token);
+    SliceResult decodeSlice();
+    SliceResult intraDecodeSlice();
+    bool loadImageSequence(const std::string& path);
+    bool loadRawStream(const std::string& uri);
+    void onRawFrame(VideoFrame&& frame);
+    bool cacheIntraFrame(int frameIndex, const AVFrame* frame);
+    bool submitIntraDecode(int frameIndex, FrameRequest::Clock::time_point deadline, size_t maxInFlight);
+    std::vector<std::pair<FrameRequest::Clock::time_point, int>> pendingRequestFrames() const;
+    void submitConvert(int frameIndex, const AVFrame* frame);
+    void cacheFrame(int frameIndex, VideoFrame&& frame, bool replace = false);
+    void fulfilRequests(int frameIndex, const std::shared_ptr<const VideoFrame>& frame);
+    void failRequests(int frameIndex, const char* reason);
+    FrameRequestHandle nextRequest();
+    int lastFrameIndex() const;
+    bool isRequested(int frameIndex) const;
+    bool isCached(int frameIndex) const;  // Hot, or compressed in the cold tier
     void evictOldFrames();
     void closeFFmpegContexts();
 };
\ No newline at end of file
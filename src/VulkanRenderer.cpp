@@ -0,0 +1,655 @@
+#include "VulkanRenderer.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <SDL2/SDL_vulkan.h>
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[VulkanRenderer] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+namespace {
+bool hasExtension(const std::vector<VkExtensionProperties>& extensions, const char* name) {
+    for (const VkExtensionProperties& extension : extensions) {
+        if (std::strcmp(extension.extensionName, name) == 0) return true;
+    }
+    return false;
+}
+
+void imageBarrier(VkCommandBuffer commands, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                  VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                  VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commands, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+VkSemaphore createSemaphore(VkDevice device, bool timeline) {
+    VkSemaphoreTypeCreateInfo typeInfo = {};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = timeline ? &typeInfo : nullptr;
+
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    vkCreateSemaphore(device, &info, nullptr, &semaphore);
+    return semaphore;
+}
+
+void waitTimeline(VkDevice device, VkSemaphore semaphore, uint64_t value) {
+    if (value == 0) return;
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+}
+}
+
+VulkanRenderer::~VulkanRenderer() {
+    if (device) {
+        vkDeviceWaitIdle(device);
+        for (Slot& slot : slots) {
+            destroySlotImage(slot);
+            if (slot.imageAcquired) vkDestroySemaphore(device, slot.imageAcquired, nullptr);
+        }
+        destroySwapchain();
+        if (uploadTimeline) vkDestroySemaphore(device, uploadTimeline, nullptr);
+        if (frameTimeline) vkDestroySemaphore(device, frameTimeline, nullptr);
+        if (graphicsPool) vkDestroyCommandPool(device, graphicsPool, nullptr);
+        if (transferPool && transferPool != graphicsPool) vkDestroyCommandPool(device, transferPool, nullptr);
+        vkDestroyDevice(device, nullptr);
+    }
+    if (surface) vkDestroySurfaceKHR(instance, surface, nullptr);
+    if (instance) vkDestroyInstance(instance, nullptr);
+}
+
+bool VulkanRenderer::init(SDL_Window* sdlWindow) {
+    window = sdlWindow;
+
+    unsigned int extensionCount = 0;
+    if (!SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, nullptr)) {
+        DEBUG_PRINT("No Vulkan surface support: " << SDL_GetError());
+        return false;
+    }
+    std::vector<const char*> instanceExtensions(extensionCount);
+    SDL_Vulkan_GetInstanceExtensions(window, &extensionCount, instanceExtensions.data());
+
+    // Timeline semaphores are core in 1.2
+    VkApplicationInfo appInfo = {};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = "consoleVideoPlayer";
+    appInfo.apiVersion = VK_API_VERSION_1_2;
+
+    VkInstanceCreateInfo instanceInfo = {};
+    instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instanceInfo.pApplicationInfo = &appInfo;
+    instanceInfo.enabledExtensionCount = (uint32_t)instanceExtensions.size();
+    instanceInfo.ppEnabledExtensionNames = instanceExtensions.data();
+
+    if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS) {
+        DEBUG_PRINT("vkCreateInstance failed");
+        return false;
+    }
+    if (!SDL_Vulkan_CreateSurface(window, instance, &surface)) {
+        DEBUG_PRINT("Surface creation failed: " << SDL_GetError());
+        return false;
+    }
+
+    if (!createDevice() || !createSwapchain()) return false;
+
+    uploadTimeline = createSemaphore(device, true);
+    frameTimeline = createSemaphore(device, true);
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = graphicsFamily;
+    vkCreateCommandPool(device, &poolInfo, nullptr, &graphicsPool);
+    if (transferFamily != graphicsFamily) {
+        poolInfo.queueFamilyIndex = transferFamily;
+        vkCreateCommandPool(device, &poolInfo, nullptr, &transferPool);
+    } else {
+        transferPool = graphicsPool;
+    }
+
+    for (Slot& slot : slots) {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        allocInfo.commandPool = transferPool;
+        vkAllocateCommandBuffers(device, &allocInfo, &slot.uploadCommands);
+        allocInfo.commandPool = graphicsPool;
+        vkAllocateCommandBuffers(device, &allocInfo, &slot.blitCommands);
+        slot.imageAcquired = createSemaphore(device, false);
+    }
+
+    if (!uploadTimeline || !frameTimeline || !graphicsPool || !transferPool) {
+        DEBUG_PRINT("Failed to create semaphores or command pools");
+        return false;
+    }
+    return true;
+}
+
+bool VulkanRenderer::createDevice() {
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+    // First 1.2 device with a queue family that does graphics and presents to our surface
+    for (VkPhysicalDevice candidate : devices) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(candidate, &properties);
+        if (properties.apiVersion < VK_API_VERSION_1_2) continue;
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, families.data());
+
+        for (uint32_t i = 0; i < familyCount; i++) {
+            VkBool32 presents = VK_FALSE;
+            vkGetPhysicalDeviceSurfaceSupportKHR(candidate, i, surface, &presents);
+            if ((families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && presents) {
+                physicalDevice = candidate;
+                graphicsFamily = transferFamily = i;
+                break;
+            }
+        }
+        if (!physicalDevice) continue;
+
+        // Transfer-only family (the copy engine on discrete GPUs) if there is one
+        for (uint32_t i = 0; i < familyCount; i++) {
+            VkQueueFlags flags = families[i].queueFlags;
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+                transferFamily = i;
+                break;
+            }
+        }
+        DEBUG_PRINT("Device: " << properties.deviceName);
+        break;
+    }
+    if (!physicalDevice) {
+        DEBUG_PRINT("No Vulkan 1.2 device that can present to the window");
+        return false;
+    }
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+
+    std::vector<const char*> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    bool presentTiming = hasExtension(extensions, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+                         hasExtension(extensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+    // Feature chain: timeline semaphores, plus present id/wait when the extensions exist
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.pNext = presentTiming ? &presentIdFeatures : nullptr;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    if (!vulkan12Features.timelineSemaphore) {
+        DEBUG_PRINT("Device lacks timeline semaphores");
+        return false;
+    }
+    presentWaitEnabled = presentTiming && presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    if (presentWaitEnabled) {
+        deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+
+    // Enable only what we use
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitEnabledFeatures = {};
+    presentWaitEnabledFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    presentWaitEnabledFeatures.presentWait = VK_TRUE;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdEnabledFeatures = {};
+    presentIdEnabledFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdEnabledFeatures.pNext = &presentWaitEnabledFeatures;
+    presentIdEnabledFeatures.presentId = VK_TRUE;
+    VkPhysicalDeviceVulkan12Features vulkan12Enabled = {};
+    vulkan12Enabled.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Enabled.pNext = presentWaitEnabled ? &presentIdEnabledFeatures : nullptr;
+    vulkan12Enabled.timelineSemaphore = VK_TRUE;
+
+    float priorities[2] = {1.0f, 1.0f};
+    VkDeviceQueueCreateInfo queueInfos[2] = {};
+    queueInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfos[0].queueFamilyIndex = graphicsFamily;
+    queueInfos[0].queueCount = 1;
+    queueInfos[0].pQueuePriorities = priorities;
+    queueInfos[1] = queueInfos[0];
+    queueInfos[1].queueFamilyIndex = transferFamily;
+
+    VkDeviceCreateInfo deviceInfo = {};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.pNext = &vulkan12Enabled;
+    deviceInfo.queueCreateInfoCount = transferFamily != graphicsFamily ? 2 : 1;
+    deviceInfo.pQueueCreateInfos = queueInfos;
+    deviceInfo.enabledExtensionCount = (uint32_t)deviceExtensions.size();
+    deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
+
+    if (vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device) != VK_SUCCESS) {
+        DEBUG_PRINT("vkCreateDevice failed");
+        return false;
+    }
+    vkGetDeviceQueue(device, graphicsFamily, 0, &graphicsQueue);
+    vkGetDeviceQueue(device, transferFamily, 0, &transferQueue);
+
+    if (presentWaitEnabled) {
+        waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device, "vkWaitForPresentKHR"));
+        presentWaitEnabled = waitForPresent != nullptr;
+    }
+    stats.dedicatedTransferQueue = transferFamily != graphicsFamily;
+    stats.presentWait = presentWaitEnabled;
+    DEBUG_PRINT("Uploads on " << (stats.dedicatedTransferQueue ? "a dedicated transfer queue" : "the graphics queue")
+                << ", present wait " << (presentWaitEnabled ? "on" : "unavailable"));
+    return true;
+}
+
+bool VulkanRenderer::createSwapchain() {
+    VkSurfaceCapabilitiesKHR capabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &capabilities);
+    if (!(capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)) {
+        DEBUG_PRINT("Swapchain images can't be blitted to");
+        return false;
+    }
+
+    // UNORM: the video is already gamma-encoded, an sRGB target would encode it twice
+    uint32_t formatCount = 0;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    if (formats.empty()) return false;
+    VkSurfaceFormatKHR format = formats[0];
+    for (const VkSurfaceFormatKHR& candidate : formats) {
+        if (candidate.format == VK_FORMAT_B8G8R8A8_UNORM || candidate.format == VK_FORMAT_R8G8B8A8_UNORM) {
+            format = candidate;
+            break;
+        }
+    }
+
+    VkExtent2D extent = capabilities.currentExtent;
+    if (extent.width == UINT32_MAX) {
+        int width = 0, height = 0;
+        SDL_Vulkan_GetDrawableSize(window, &width, &height);
+        extent.width = std::clamp((uint32_t)width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+        extent.height = std::clamp((uint32_t)height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+    }
+    if (extent.width == 0 || extent.height == 0) return false;  // Minimised
+
+    uint32_t imageCount = capabilities.minImageCount + 1;
+    if (capabilities.maxImageCount > 0) imageCount = std::min(imageCount, capabilities.maxImageCount);
+
+    VkSwapchainKHR oldSwapchain = swapchain;
+    VkSwapchainCreateInfoKHR info = {};
+    info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    info.surface = surface;
+    info.minImageCount = imageCount;
+    info.imageFormat = format.format;
+    info.imageColorSpace = format.colorSpace;
+    info.imageExtent = extent;
+    info.imageArrayLayers = 1;
+    info.imageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    info.preTransform = capabilities.currentTransform;
+    info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    info.presentMode = VK_PRESENT_MODE_FIFO_KHR;  // vsync, always supported
+    info.clipped = VK_TRUE;
+    info.oldSwapchain = oldSwapchain;
+
+    if (vkCreateSwapchainKHR(device, &info, nullptr, &swapchain) != VK_SUCCESS) {
+        DEBUG_PRINT("vkCreateSwapchainKHR failed");
+        swapchain = oldSwapchain;
+        return false;
+    }
+    if (oldSwapchain) vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+
+    swapchainFormat = format.format;
+    swapchainExtent = extent;
+    vkGetSwapchainImagesKHR(device, swapchain, &imageCount, nullptr);
+    swapchainImages.resize(imageCount);
+    vkGetSwapchainImagesKHR(device, swapchain, &imageCount, swapchainImages.data());
+
+    for (VkSemaphore semaphore : renderDone) vkDestroySemaphore(device, semaphore, nullptr);
+    renderDone.clear();
+    for (uint32_t i = 0; i < imageCount; i++) {
+        renderDone.push_back(createSemaphore(device, false));
+    }
+
+    swapchainStale = false;
+    DEBUG_PRINT("Swapchain " << extent.width << "x" << extent.height << ", " << imageCount << " images");
+    return true;
+}
+
+void VulkanRenderer::destroySwapchain() {
+    for (VkSemaphore semaphore : renderDone) vkDestroySemaphore(device, semaphore, nullptr);
+    renderDone.clear();
+    if (swapchain) vkDestroySwapchainKHR(device, swapchain, nullptr);
+    swapchain = VK_NULL_HANDLE;
+    swapchainImages.clear();
+}
+
+bool VulkanRenderer::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t& typeIndex) const {
+    VkPhysicalDeviceMemoryProperties memory;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memory);
+    for (uint32_t i = 0; i < memory.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) && (memory.memoryTypes[i].propertyFlags & properties) == properties) {
+            typeIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VulkanRenderer::createSlotImage(Slot& slot, int width, int height) {
+    destroySlotImage(slot);
+    VkDeviceSize bytes = (VkDeviceSize)width * height * 4;
+
+    // Staging: host-visible, coherent, mapped for the slot's lifetime
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = bytes;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &slot.staging) != VK_SUCCESS) return false;
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, slot.staging, &requirements);
+    VkMemoryAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = requirements.size;
+    if (!findMemoryType(requirements.memoryTypeBits,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        allocInfo.memoryTypeIndex) ||
+        vkAllocateMemory(device, &allocInfo, nullptr, &slot.stagingMemory) != VK_SUCCESS) {
+        return false;
+    }
+    vkBindBufferMemory(device, slot.staging, slot.stagingMemory, 0);
+    void* mapped = nullptr;
+    vkMapMemory(device, slot.stagingMemory, 0, bytes, 0, &mapped);
+    slot.stagingPixels = static_cast<uint8_t*>(mapped);
+
+    // Device-local image, shared between the transfer and graphics families
+    uint32_t families[2] = {transferFamily, graphicsFamily};
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;  // Blit source + linear filter are mandatory for it
+    imageInfo.extent = {(uint32_t)width, (uint32_t)height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (transferFamily != graphicsFamily) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = 2;
+        imageInfo.pQueueFamilyIndices = families;
+    } else {
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+    if (vkCreateImage(device, &imageInfo, nullptr, &slot.image) != VK_SUCCESS) return false;
+
+    vkGetImageMemoryRequirements(device, slot.image, &requirements);
+    allocInfo.allocationSize = requirements.size;
+    if (!findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocInfo.memoryTypeIndex) ||
+        vkAllocateMemory(device, &allocInfo, nullptr, &slot.imageMemory) != VK_SUCCESS) {
+        return false;
+    }
+    vkBindImageMemory(device, slot.image, slot.imageMemory, 0);
+
+    slot.width = width;
+    slot.height = height;
+    slot.bufferId = 0;
+    return true;
+}
+
+void VulkanRenderer::destroySlotImage(Slot& slot) {
+    if (slot.stagingMemory) vkFreeMemory(device, slot.stagingMemory, nullptr);  // Unmaps
+    if (slot.staging) vkDestroyBuffer(device, slot.staging, nullptr);
+    if (slot.image) vkDestroyImage(device, slot.image, nullptr);
+    if (slot.imageMemory) vkFreeMemory(device, slot.imageMemory, nullptr);
+    slot.staging = VK_NULL_HANDLE;
+    slot.stagingMemory = VK_NULL_HANDLE;
+    slot.stagingPixels = nullptr;
+    slot.image = VK_NULL_HANDLE;
+    slot.imageMemory = VK_NULL_HANDLE;
+    slot.width = slot.height = 0;
+    slot.bufferId = 0;
+}
+
+void VulkanRenderer::setScaleMode(OutputLayout::ScaleMode mode) {
+    scaleMode = mode;
+}
+
+void VulkanRenderer::upload(Slot& slot, const VideoFrame& frame) {
+    // RGB24 -> RGBA while copying into the mapped staging buffer (no 3-byte
+    // format is blittable); this is the only CPU pass over the pixels
+    const uint8_t* source = frame.pixels();
+    uint8_t* destination = slot.stagingPixels;
+    for (int y = 0; y < frame.height; y++) {
+        const uint8_t* row = source + (size_t)y * frame.linesize;
+        for (int x = 0; x < frame.width; x++) {
+            destination[0] = row[0];
+            destination[1] = row[1];
+            destination[2] = row[2];
+            destination[3] = 255;
+            destination += 4;
+            row += 3;
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(slot.uploadCommands, &beginInfo);
+
+    // Previous contents are discarded; the blit that read them has finished (frameTimeline)
+    imageBarrier(slot.uploadCommands, slot.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    VkBufferImageCopy region = {};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {(uint32_t)frame.width, (uint32_t)frame.height, 1};
+    vkCmdCopyBufferToImage(slot.uploadCommands, slot.staging, slot.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    // Made visible to the graphics queue by the timeline semaphore
+    imageBarrier(slot.uploadCommands, slot.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, 0,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    vkEndCommandBuffer(slot.uploadCommands);
+
+    uint64_t signalValue = ++uploadSerial;
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submit = {};
+    submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit.pNext = &timelineInfo;
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &slot.uploadCommands;
+    submit.signalSemaphoreCount = 1;
+    submit.pSignalSemaphores = &uploadTimeline;
+    vkQueueSubmit(transferQueue, 1, &submit, VK_NULL_HANDLE);
+
+    slot.uploadValue = signalValue;
+    slot.bufferId = frame.bufferId;
+    stats.uploads++;
+}
+
+void VulkanRenderer::recordBlit(Slot& slot, uint32_t imageIndex) {
+    VkImage target = swapchainImages[imageIndex];
+    VkCommandBuffer commands = slot.blitCommands;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commands, &beginInfo);
+
+    imageBarrier(commands, target, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    // Black bars, then the video on top
+    VkClearColorValue black = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdClearColorImage(commands, target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &black, 1, &range);
+    imageBarrier(commands, target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+    // The scale mode's quad, clipped to the output (crop mode overhangs); the
+    // source rectangle shrinks with it
+    int outputWidth = (int)swapchainExtent.width;
+    int outputHeight = (int)swapchainExtent.height;
+    OutputLayout::Quad quad = OutputLayout::fit(scaleMode, outputWidth, outputHeight, slot.width, slot.height);
+    float left = std::max(quad.x, 0.0f);
+    float top = std::max(quad.y, 0.0f);
+    float right = std::min(quad.x + quad.width, (float)outputWidth);
+    float bottom = std::min(quad.y + quad.height, (float)outputHeight);
+    float scaleX = slot.width / quad.width;
+    float scaleY = slot.height / quad.height;
+
+    VkImageBlit blit = {};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[0] = {(int32_t)((left - quad.x) * scaleX), (int32_t)((top - quad.y) * scaleY), 0};
+    blit.srcOffsets[1] = {(int32_t)((right - quad.x) * scaleX + 0.5f), (int32_t)((bottom - quad.y) * scaleY + 0.5f), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[0] = {(int32_t)left, (int32_t)top, 0};
+    blit.dstOffsets[1] = {(int32_t)(right + 0.5f), (int32_t)(bottom + 0.5f), 1};
+    vkCmdBlitImage(commands, slot.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+    imageBarrier(commands, target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                 VK_ACCESS_TRANSFER_WRITE_BIT, 0,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    vkEndCommandBuffer(commands);
+}
+
+void VulkanRenderer::present(const VideoFrame& frame) {
+    if (frame.format != VideoFrame::RGB24) return;
+    if (swapchainStale) {
+        vkDeviceWaitIdle(device);
+        if (!createSwapchain()) return;  // Minimised - try again next frame
+    }
+
+    // Reuse the slot once the GPU is done with its last frame - this also bounds
+    // how far the CPU runs ahead of the GPU to FRAMES_IN_FLIGHT
+    Slot& slot = slots[frameSerial % FRAMES_IN_FLIGHT];
+    waitTimeline(device, frameTimeline, slot.frameValue);
+    // A present that returned after uploading (acquire failed) didn't advance
+    // frameSerial, so this is the same slot and its copy may still be reading
+    // the staging buffer and command buffer
+    waitTimeline(device, uploadTimeline, slot.uploadValue);
+
+    if (slot.width != frame.width || slot.height != frame.height) {
+        if (!createSlotImage(slot, frame.width, frame.height)) {
+            DEBUG_PRINT("Failed to allocate a " << frame.width << "x" << frame.height << " upload slot");
+            destroySlotImage(slot);
+            return;
+        }
+    }
+    if (slot.bufferId != frame.bufferId || frame.bufferId == 0) {
+        upload(slot, frame);
+    } else {
+        stats.uploadsSkipped++;
+    }
+
+    uint32_t imageIndex = 0;
+    VkResult acquired = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, slot.imageAcquired,
+                                              VK_NULL_HANDLE, &imageIndex);
+    if (acquired == VK_ERROR_OUT_OF_DATE_KHR) {
+        swapchainStale = true;
+        return;
+    }
+    if (acquired != VK_SUCCESS && acquired != VK_SUBOPTIMAL_KHR) return;
+
+    recordBlit(slot, imageIndex);
+
+    // Wait for the swapchain image and this slot's upload; signal present + frame done
+    uint64_t frameValue = ++frameSerial;
+    VkSemaphore waitSemaphores[2] = {slot.imageAcquired, uploadTimeline};
+    uint64_t waitValues[2] = {0, slot.uploadValue};
+    VkPipelineStageFlags waitStages[2] = {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT};
+    VkSemaphore signalSemaphores[2] = {renderDone[imageIndex], frameTimeline};
+    uint64_t signalValues[2] = {0, frameValue};
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 2;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    timelineInfo.signalSemaphoreValueCount = 2;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+
+    VkSubmitInfo submit = {};
+    submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit.pNext = &timelineInfo;
+    submit.waitSemaphoreCount = 2;
+    submit.pWaitSemaphores = waitSemaphores;
+    submit.pWaitDstStageMask = waitStages;
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &slot.blitCommands;
+    submit.signalSemaphoreCount = 2;
+    submit.pSignalSemaphores = signalSemaphores;
+    vkQueueSubmit(graphicsQueue, 1, &submit, VK_NULL_HANDLE);
+    slot.frameValue = frameValue;
+    slot.submitTime = std::chrono::steady_clock::now();
+
+    VkPresentIdKHR presentId = {};
+    presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentId.swapchainCount = 1;
+    presentId.pPresentIds = &frameValue;
+
+    VkPresentInfoKHR presentInfo = {};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.pNext = presentWaitEnabled ? &presentId : nullptr;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &renderDone[imageIndex];
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &swapchain;
+    presentInfo.pImageIndices = &imageIndex;
+    VkResult presented = vkQueuePresentKHR(graphicsQueue, &presentInfo);
+    if (presented == VK_ERROR_OUT_OF_DATE_KHR || presented == VK_SUBOPTIMAL_KHR) {
+        swapchainStale = true;
+    }
+    stats.framesPresented++;
+
+    // Keep one frame queued: return once the previous one is on screen, so the
+    // render loop samples the transport at a steady point after each vblank
+    if (presentWaitEnabled && frameValue > 1) {
+        const Slot& previous = slots[(frameValue - 2) % FRAMES_IN_FLIGHT];
+        if (waitForPresent(device, swapchain, frameValue - 1, 100000000) == VK_SUCCESS) {
+            double latencyMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - previous.submitTime).count();
+            stats.lastPresentLatencyMs = latencyMs;
+            stats.maxPresentLatencyMs = std::max(stats.maxPresentLatencyMs, latencyMs);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <vulkan/vulkan.h>
+
+#include "OutputLayout.h"
+#include "VideoFrame.h"
+
+// Optional Vulkan presentation ("renderer": "vulkan", built when CMake finds
+// Vulkan). Frames are copied into persistently mapped host-visible staging
+// buffers and uploaded on a transfer queue - a dedicated one when the device
+// has it - then the graphics queue blits them to the swapchain with the
+// scale mode applied. Timeline semaphores order upload -> blit and bound the
+// frames in flight. With VK_KHR_present_id + VK_KHR_present_wait, present()
+// returns once the previous frame is actually on screen, so exactly one
+// frame is queued instead of whatever depth SDL_GL_SwapWindow leaves to the
+// driver. RGB24 only: there are no shaders on this path, so high-bit-depth
+// sources are converted to RGB24 and interlaced ones are shown woven.
+class VulkanRenderer {
+public:
+    VulkanRenderer() = default;
+    ~VulkanRenderer();
+
+    // window must be created with SDL_WINDOW_VULKAN. False (logged) if there's
+    // no usable device - the caller falls back to GL.
+    bool init(SDL_Window* window);
+
+    void setScaleMode(OutputLayout::ScaleMode mode);
+    // Window resized: the swapchain is rebuilt before the next present
+    void resize() { swapchainStale = true; }
+
+    // Upload the frame (unless its buffer is already in the slot) and present it
+    void present(const VideoFrame& frame);
+
+    struct Stats {
+        uint64_t framesPresented = 0;
+        uint64_t uploads = 0;
+        uint64_t uploadsSkipped = 0;
+        bool dedicatedTransferQueue = false;
+        bool presentWait = false;           // VK_KHR_present_wait in use
+        double lastPresentLatencyMs = 0.0;  // Submit -> on screen (present wait only)
+        double maxPresentLatencyMs = 0.0;
+    };
+    Stats getStats() const { return stats; }
+
+private:
+    static constexpr int FRAMES_IN_FLIGHT = 2;
+
+    // One frame in flight: its staging buffer, uploaded image and command buffers
+    struct Slot {
+        VkBuffer staging = VK_NULL_HANDLE;
+        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+        uint8_t* stagingPixels = nullptr;  // Persistently mapped
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+        int width = 0;
+        int height = 0;
+        uint64_t bufferId = 0;       // Frame buffer the image holds (0 = none)
+        uint64_t uploadValue = 0;    // uploadTimeline value when the image is ready
+        uint64_t frameValue = 0;     // frameTimeline value when the slot is free again
+        VkCommandBuffer uploadCommands = VK_NULL_HANDLE;
+        VkCommandBuffer blitCommands = VK_NULL_HANDLE;
+        VkSemaphore imageAcquired = VK_NULL_HANDLE;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    bool createDevice();
+    bool createSwapchain();
+    void destroySwapchain();
+    bool createSlotImage(Slot& slot, int width, int height);
+    void destroySlotImage(Slot& slot);
+    bool findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t& typeIndex) const;
+    void upload(Slot& slot, const VideoFrame& frame);
+    void recordBlit(Slot& slot, uint32_t imageIndex);
+
+    SDL_Window* window = nullptr;
+    OutputLayout::ScaleMode scaleMode = OutputLayout::ScaleMode::Letterbox;
+
+    VkInstance instance = VK_NULL_HANDLE;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t graphicsFamily = 0;
+    uint32_t transferFamily = 0;
+    VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    VkCommandPool graphicsPool = VK_NULL_HANDLE;
+    VkCommandPool transferPool = VK_NULL_HANDLE;
+
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    VkFormat swapchainFormat = VK_FORMAT_UNDEFINED;
+    VkExtent2D swapchainExtent = {0, 0};
+    std::vector<VkImage> swapchainImages;
+    std::vector<VkSemaphore> renderDone;  // Per swapchain image
+    bool swapchainStale = false;
+
+    VkSemaphore uploadTimeline = VK_NULL_HANDLE;  // Signalled by the transfer queue
+    VkSemaphore frameTimeline = VK_NULL_HANDLE;   // Signalled by the graphics queue per frame
+    uint64_t uploadSerial = 0;
+    uint64_t frameSerial = 0;
+    Slot slots[FRAMES_IN_FLIGHT];
+
+    bool presentWaitEnabled = false;
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+
+    Stats stats;
+};
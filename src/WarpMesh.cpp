@@ -0,0 +1,96 @@
+#include "WarpMesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+constexpr int MAX_POINTS = 1 << 20;
+
+// Next line that isn't blank or a comment
+bool nextLine(std::ifstream& file, std::string& line, int& lineNumber) {
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start != std::string::npos && line[start] != '#') return true;
+    }
+    return false;
+}
+}
+
+bool WarpMesh::load(const std::string& path, WarpMesh& mesh, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "can't open " + path;
+        return false;
+    }
+
+    mesh = WarpMesh();
+    std::string line;
+    int lineNumber = 0;
+    if (!nextLine(file, line, lineNumber) || !(std::istringstream(line) >> mesh.columns >> mesh.rows) ||
+        mesh.columns < 2 || mesh.rows < 2 || (long long)mesh.columns * mesh.rows > MAX_POINTS) {
+        error = "expected \"columns rows\" (2 or more each) first";
+        return false;
+    }
+
+    size_t count = (size_t)mesh.columns * mesh.rows;
+    mesh.points.reserve(count);
+    while (mesh.points.size() < count && nextLine(file, line, lineNumber)) {
+        Point point;
+        if (!(std::istringstream(line) >> point.x >> point.y >> point.u >> point.v)) {
+            error = "bad point on line " + std::to_string(lineNumber);
+            return false;
+        }
+        mesh.points.push_back(point);
+    }
+    if (mesh.points.size() != count) {
+        error = "expected " + std::to_string(count) + " points, found " + std::to_string(mesh.points.size());
+        return false;
+    }
+    return true;
+}
+
+WarpMesh WarpMesh::fromCorners(const float corners[8], int subdivisions) {
+    // Projective map of the unit square onto the corners (Heckbert):
+    // x = (a s + b t + c) / (g s + h t + 1), y = (d s + e t + f) / (g s + h t + 1)
+    float x0 = corners[0], y0 = corners[1], x1 = corners[2], y1 = corners[3];
+    float x2 = corners[4], y2 = corners[5], x3 = corners[6], y3 = corners[7];
+    float sx = x0 - x1 + x2 - x3;
+    float sy = y0 - y1 + y2 - y3;
+    float a, b, c = x0, d, e, f = y0, g = 0.0f, h = 0.0f;
+    if (std::fabs(sx) < 1e-6f && std::fabs(sy) < 1e-6f) {
+        a = x1 - x0; b = x3 - x0;
+        d = y1 - y0; e = y3 - y0;
+    } else {
+        float dx1 = x1 - x2, dx2 = x3 - x2;
+        float dy1 = y1 - y2, dy2 = y3 - y2;
+        float det = dx1 * dy2 - dx2 * dy1;
+        if (std::fabs(det) < 1e-9f) det = 1e-9f;  // Degenerate corners: draws something, not NaNs
+        g = (sx * dy2 - dx2 * sy) / det;
+        h = (dx1 * sy - sx * dy1) / det;
+        a = x1 - x0 + g * x1; b = x3 - x0 + h * x3;
+        d = y1 - y0 + g * y1; e = y3 - y0 + h * y3;
+    }
+
+    WarpMesh mesh;
+    int cells = std::max(subdivisions, 1);
+    mesh.columns = mesh.rows = cells + 1;
+    mesh.points.reserve((size_t)mesh.columns * mesh.rows);
+    for (int row = 0; row <= cells; row++) {
+        for (int column = 0; column <= cells; column++) {
+            float s = (float)column / cells;
+            float t = (float)row / cells;
+            float w = g * s + h * t + 1.0f;
+            mesh.points.push_back({(a * s + b * t + c) / w, (d * s + e * t + f) / w, s, t});
+        }
+    }
+    return mesh;
+}
+
+bool WarpMesh::parseCorners(const std::string& text, float corners[8]) {
+    return std::sscanf(text.c_str(), " %f , %f %f , %f %f , %f %f , %f",
+                       &corners[0], &corners[1], &corners[2], &corners[3],
+                       &corners[4], &corners[5], &corners[6], &corners[7]) == 8;
+}
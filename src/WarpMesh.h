@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Output warp for projector alignment: a grid of points, each placing a spot
+// of the laid-out picture somewhere in the output. Drawn by GlRenderer as
+// triangles in place of the single quad.
+//
+// File format (text, '#' comments):
+//   columns rows
+//   x y u v        <- columns * rows lines, row by row from the top left
+// x, y: where the point lands in the output (0..1, top-left origin)
+// u, v: which spot of the unwarped output it shows (0..1, top-left origin),
+//       so the identity mesh has u = x and v = y, and the scale mode still
+//       applies underneath the warp.
+struct WarpMesh {
+    struct Point {
+        float x, y;
+        float u, v;
+    };
+    int columns = 0;
+    int rows = 0;
+    std::vector<Point> points;  // Row-major
+
+    const Point& at(int column, int row) const { return points[(size_t)row * columns + column]; }
+
+    // False with error set on a malformed file
+    static bool load(const std::string& path, WarpMesh& mesh, std::string& error);
+
+    // Keystone: the whole output pulled to four corners (top left, top right,
+    // bottom right, bottom left as x, y pairs, 0..1). Perspective-correct,
+    // subdivided so the per-triangle interpolation stays close to it.
+    static WarpMesh fromCorners(const float corners[8], int subdivisions = 16);
+    // "x,y x,y x,y x,y" in that order; false if it doesn't parse
+    static bool parseCorners(const std::string& text, float corners[8]);
+};
@@ -0,0 +1,214 @@
+#include "YuvPlaneRenderer.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <SDL2/SDL.h>
+#include "GlShader.h"
+#include "GlRenderer.h"
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+#define DEBUG_PRINT(msg) do { \
+    std::cout << "[YuvPlaneRenderer] " << msg << std::endl; \
+    std::cout.flush(); \
+} while(0)
+
+using namespace GlShader;
+
+namespace {
+const char* FRAGMENT_SHADER = R"(
+uniform sampler2D lumaPlane;
+uniform sampler2D chromaPlane;
+uniform sampler2D crPlane;
+uniform float sampleScale;
+uniform vec3 offset;
+uniform mat3 yuvToRgb;
+uniform float field;  // < 0: progressive, else the parity of the lines to show (bob)
+uniform float lines;
+
+vec3 rgbAt(vec2 tc) {
+    float y = texture2D(lumaPlane, tc).r;
+#ifdef SEMI_PLANAR
+    vec2 c = texture2D(chromaPlane, tc).CHROMA_SWIZZLE;
+#else
+    vec2 c = vec2(texture2D(chromaPlane, tc).r, texture2D(crPlane, tc).r);
+#endif
+    return yuvToRgb * (vec3(y, c) * sampleScale - offset);
+}
+
+void main() {
+    vec2 tc = texCoord;
+    vec3 rgb;
+    if (field < 0.0) {
+        rgb = rgbAt(tc);
+    } else {
+        // One field, its missing lines interpolated from the lines above and below
+        float line = floor(tc.y * lines);
+        if (mod(line, 2.0) == field) {
+            rgb = rgbAt(vec2(tc.x, (line + 0.5) / lines));
+        } else {
+            rgb = 0.5 * (rgbAt(vec2(tc.x, (line - 0.5) / lines)) + rgbAt(vec2(tc.x, (line + 1.5) / lines)));
+        }
+    }
+    FRAG_COLOR = outputColor(clamp(rgb, 0.0, 1.0));
+}
+)";
+
+// Y'CbCr (normalised to the source bit depth) -> RGB, with the range
+// expansion folded in. Column-major for glUniformMatrix3fv.
+void colorMatrix(const VideoFrame& frame, float matrix[9], float offset[3]) {
+    float kr, kb;
+    switch (frame.colorSpace) {
+        case AVCOL_SPC_BT2020_NCL:
+        case AVCOL_SPC_BT2020_CL:
+            kr = 0.2627f; kb = 0.0593f;
+            break;
+        case AVCOL_SPC_BT470BG:
+        case AVCOL_SPC_SMPTE170M:
+            kr = 0.299f; kb = 0.114f;
+            break;
+        case AVCOL_SPC_BT709:
+            kr = 0.2126f; kb = 0.0722f;
+            break;
+        default:  // Unspecified: go by size, as players usually do
+            if (frame.height > 576) { kr = 0.2126f; kb = 0.0722f; }
+            else { kr = 0.299f; kb = 0.114f; }
+            break;
+    }
+    float kg = 1.0f - kr - kb;
+
+    // Levels are the 8-bit ones shifted up to the bit depth (64-940 / 64-960
+    // at 10 bits), over the depth's own code range: sampleScale has already
+    // undone the MSB/LSB packing, so samples are code / (2^depth - 1)
+    int shift = std::max(0, frame.bitDepth - 8);
+    float maxCode = (float)((1 << (8 + shift)) - 1);
+    float lumaScale = frame.fullRange ? 1.0f : maxCode / (float)(219 << shift);
+    float chromaScale = frame.fullRange ? 1.0f : maxCode / (float)(224 << shift);
+    offset[0] = frame.fullRange ? 0.0f : (float)(16 << shift) / maxCode;
+    offset[1] = offset[2] = (float)(128 << shift) / maxCode;
+
+    // Columns: Y, Cb, Cr
+    matrix[0] = lumaScale;
+    matrix[1] = lumaScale;
+    matrix[2] = lumaScale;
+    matrix[3] = 0.0f;
+    matrix[4] = -2.0f * kb * (1.0f - kb) / kg * chromaScale;
+    matrix[5] = 2.0f * (1.0f - kb) * chromaScale;
+    matrix[6] = 2.0f * (1.0f - kr) * chromaScale;
+    matrix[7] = -2.0f * kr * (1.0f - kr) / kg * chromaScale;
+    matrix[8] = 0.0f;
+}
+}
+
+YuvPlaneRenderer::~YuvPlaneRenderer() {
+    if (textures[0]) glDeleteTextures(3, textures);
+    if (planarProgram.id) deleteProgram(planarProgram.id);
+    if (semiPlanarProgram.id) deleteProgram(semiPlanarProgram.id);
+}
+
+bool YuvPlaneRenderer::init() {
+    if (!GlShader::load()) {
+        DEBUG_PRINT("GLSL not available - high bit depth sources fall back to RGB24");
+        return false;
+    }
+    if (getDialect() == Dialect::Gles100) {
+        DEBUG_PRINT("No 16-bit textures on GLES 2 - high bit depth sources fall back to RGB24");
+        return false;
+    }
+
+    // R16/RG16 are core in GL 3.x
+    textureRg = getDialect() == Dialect::Glsl330 || SDL_GL_ExtensionSupported("GL_ARB_texture_rg");
+
+    if (!buildProgram(planarProgram, false) || !buildProgram(semiPlanarProgram, true)) {
+        if (planarProgram.id) deleteProgram(planarProgram.id);
+        planarProgram = Program();
+        return false;
+    }
+
+    glGenTextures(3, textures);
+    for (GLuint texture : textures) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    DEBUG_PRINT("High bit depth shader ready (" << (textureRg ? "R16/RG16" : "LUMINANCE16") << " planes)");
+    return true;
+}
+
+bool YuvPlaneRenderer::buildProgram(Program& program, bool semiPlanar) {
+    // LUMINANCE_ALPHA puts the second sample in .a instead of .g
+    std::string defines;
+    if (semiPlanar) {
+        defines += "#define SEMI_PLANAR\n";
+        defines += textureRg ? "#define CHROMA_SWIZZLE rg\n" : "#define CHROMA_SWIZZLE ra\n";
+    }
+
+    GLuint id = buildQuadProgram(defines + FRAGMENT_SHADER, "YuvPlaneRenderer");
+    if (!id) return false;
+
+    program.id = id;
+    program.sampleScale = getUniformLocation(id, "sampleScale");
+    program.offset = getUniformLocation(id, "offset");
+    program.yuvToRgb = getUniformLocation(id, "yuvToRgb");
+    program.field = getUniformLocation(id, "field");
+    program.lines = getUniformLocation(id, "lines");
+
+    useProgram(id);
+    uniform1i(getUniformLocation(id, "lumaPlane"), 0);
+    uniform1i(getUniformLocation(id, "chromaPlane"), 1);
+    if (!semiPlanar) uniform1i(getUniformLocation(id, "crPlane"), 2);
+    useProgram(0);
+    return true;
+}
+
+void YuvPlaneRenderer::upload(const VideoFrame& frame, const uint8_t* pixels) {
+    for (int plane = 0; plane < frame.planeCount; plane++) {
+        const VideoFrame::Plane& layout = frame.planes[plane];
+        bool pairs = plane > 0 && frame.planeCount == 2;
+        GLint internalFormat = pairs ? (textureRg ? GL_RG16 : GL_LUMINANCE16_ALPHA16)
+                                     : (textureRg ? GL_R16 : GL_LUMINANCE16);
+        GLenum format = pairs ? (textureRg ? GL_RG : GL_LUMINANCE_ALPHA)
+                              : (textureRg ? GL_RED : GL_LUMINANCE);
+        const void* source = pixels ? static_cast<const void*>(pixels + layout.offset)
+                                    : reinterpret_cast<const void*>(layout.offset);
+
+        glBindTexture(GL_TEXTURE_2D, textures[plane]);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, layout.width, layout.height, 0,
+                     format, GL_UNSIGNED_SHORT, source);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void YuvPlaneRenderer::draw(const VideoFrame& frame, GlRenderer& renderer, int field) {
+    const Program& program = (frame.planeCount == 2) ? semiPlanarProgram : planarProgram;
+
+    for (int plane = 0; plane < frame.planeCount; plane++) {
+        glActiveTexture(GL_TEXTURE0 + plane);
+        glBindTexture(GL_TEXTURE_2D, textures[plane]);
+    }
+
+    float matrix[9];
+    float offset[3];
+    colorMatrix(frame, matrix, offset);
+
+    useQuadProgram(program.id);
+    uniform1f(program.sampleScale, frame.sampleScale);
+    uniform3f(program.offset, offset[0], offset[1], offset[2]);
+    uniformMatrix3fv(program.yuvToRgb, 1, GL_FALSE, matrix);
+    uniform1f(program.field, (float)field);
+    uniform1f(program.lines, (float)frame.height);
+
+    renderer.drawQuad();
+
+    useProgram(0);
+    for (int plane = frame.planeCount - 1; plane >= 0; plane--) {
+        glActiveTexture(GL_TEXTURE0 + plane);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <GL/gl.h>
+
+#include "VideoFrame.h"
+
+class GlRenderer;
+
+// Draws high-bit-depth frames (VideoFrame::YUV16). Each plane goes to a
+// 16-bit texture - R16, or RG16 for interleaved CbCr (LUMINANCE16 /
+// LUMINANCE16_ALPHA16 where GL lacks texture_rg) - and a shader does
+// YUV -> RGB, so 10/12-bit sources reach the screen without the CPU
+// dithering them to 8-bit first.
+class YuvPlaneRenderer {
+public:
+    YuvPlaneRenderer() = default;
+    ~YuvPlaneRenderer();
+
+    // Needs the GL context current. False if shaders aren't available.
+    bool init();
+    bool isReady() const { return planarProgram.id != 0; }
+
+    // Upload the frame's planes. pixels is the frame data, or nullptr to
+    // read from the bound GL_PIXEL_UNPACK_BUFFER at the plane offsets.
+    void upload(const VideoFrame& frame, const uint8_t* pixels);
+
+    // Draw the uploaded planes on the renderer's quad. field >= 0 shows only
+    // the lines of that parity (0 = top), bobbed to full height.
+    void draw(const VideoFrame& frame, GlRenderer& renderer, int field = -1);
+
+private:
+    struct Program {
+        GLuint id = 0;
+        GLint sampleScale = -1;
+        GLint offset = -1;
+        GLint yuvToRgb = -1;
+        GLint field = -1;
+        GLint lines = -1;
+    };
+
+    Program planarProgram;      // Y, Cb, Cr in three textures
+    Program semiPlanarProgram;  // Y, then CbCr interleaved in one
+    GLuint textures[3] = {0, 0, 0};
+    bool textureRg = false;
+
+    bool buildProgram(Program& program, bool semiPlanar);
+};
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <filesystem>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
 #include <signal.h>
 #include <execinfo.h>
 #include <unistd.h>
@@ -9,6 +13,22 @@
 
 #include "VideoPlayer.h"
 #include "JackTransportClient.h"
+#include "MemoryPressureMonitor.h"
+#include "DecodePool.h"
+#include "ThreadingBenchmark.h"
+#include "ImageSequence.h"
+#include "YuvPlaneRenderer.h"
+#include "Deinterlacer.h"
+#include "FrameBlender.h"
+#include "GlRenderer.h"
+#include "ColorLut.h"
+#include "OutputWindow.h"
+#include "SoftwareRenderer.h"
+#include "ScalerBenchmark.h"
+#include "RendererCheck.h"
+#ifdef HAVE_VULKAN
+#include "VulkanRenderer.h"
+#endif
 
 // PBO function pointers (manually loaded GL extensions)
 PFNGLGENBUFFERSPROC glGenBuffers = nullptr;
@@ -37,14 +57,89 @@ void signal_handler(int sig) {
     std::cout.flush(); \
 } while(0)
 
+// How often the render loop prints cache/pipeline counters
+constexpr int STATS_INTERVAL_SECONDS = 10;
+
 struct Settings {
     std::string videoFilePath = "../test_video.mp4";
     int udpPort = 8080;
     bool fullscreen = true;
     std::string windowTitle = "Video Player";
     std::string scaleMode = "letterbox";  // Options: "letterbox", "stretch", "crop"
+    // GL backend: "auto" (core, then gles2, then legacy), "core" (GL 3.3),
+    // "gles2" (KMS/DRM boards), "legacy" (GL 2.1 fixed function), or
+    // "vulkan" (RGB24 blit presenter, falls back to "auto" when unavailable),
+    // "software" (CPU scaling, no GL - also used when every GL backend fails)
+    std::string renderer = "auto";
+    int coldCacheMB = 1024;  // Compressed frame tier behind the decoded cache (0 = off)
+    std::string frameMemory = "default";  // Options: "default", "thp", "hugetlb"
+    bool lockFrameMemory = false;          // mlock frame buffers (needs LimitMEMLOCK)
+    bool adaptiveMemory = true;  // Shrink caches under cgroup limit / PSI memory pressure
+    bool thumbnails = true;             // Show keyframe thumbnails while a locate decodes
+    int thumbnailCacheMB = 128;
+    double thumbnailIntervalSeconds = 0.0;  // 0 = one per keyframe
+    std::string thumbnailCachePath;         // Persist the index between runs ("" = off)
+    int decodeThreads = 0;  // Shared decode/convert pool size for all players (0 = one per core)
+    // Codec threading per decoder role: "frame", "slice", "frame+slice", "none"
+    // (threads 0 = share of the pool). Compare with --bench-threading <video>.
+    std::string playbackThreading = "frame";
+    int playbackThreads = 0;
+    std::string seekThreading = "slice";
+    int seekThreads = 0;
+    bool intraFastPath = true;  // All-intra sources: decode frames in parallel, any order
+    double sequenceFrameRate = 25.0;  // For image sequences (videoFilePath = directory or %04d pattern)
+    // Raw frame input (videoFilePath = "-", "pipe:<fifo>", "shm:<name>" or "memfd:/proc/<pid>/fd/<n>")
+    int rawWidth = 0;                 // Pipes only - rings describe themselves
+    int rawHeight = 0;
+    std::string rawFormat = "rgb24";  // "rgb24", "rgba", "yuv420p", "nv12"
+    double rawFrameRate = 60.0;       // Timeline the arriving frames are stamped on
+    bool rawLatestOnly = false;       // Always show the newest frame, no caching (lowest latency)
+    // Video streams decoded in parallel, sharing the cache budget: "0", "0,2" or "all".
+    // Keys 1-9 switch between them at the next frame.
+    std::string videoStreams = "0";
+    bool highBitDepth = true;  // 10/12-bit YUV: cache the 16-bit planes, convert to RGB in a shader
+    // Interlaced sources, one field per refresh: "off", "bob", "motion" (weave where static)
+    std::string deinterlace = "motion";
+    // Cross-fade each frame into the next by the transport's position between
+    // them, so 24/25/30fps doesn't judder on a 50/60Hz display (RGB, progressive)
+    bool frameBlending = false;
+    // .cube 3D LUT applied on the GPU for projector colour matching ("" = none).
+    // Changing this key, or rewriting the file, swaps it live; L toggles bypass.
+    std::string colorLut;
+    // Projector alignment, both live like colorLut. warpMesh: mesh file (see
+    // WarpMesh.h); warpCorners: keystone "x,y x,y x,y x,y" (TL TR BR BL, 0..1),
+    // used when warpMesh is empty. blendMask: image multiplied over the output
+    // for edge blending ("" = none).
+    std::string warpMesh;
+    std::string warpCorners;
+    std::string blendMask;
+    // Video wall node: keep only this node's part of each frame - conversion,
+    // cache and upload shrink with it. roi: "x,y,width,height" in source
+    // pixels; or wallGrid "columns,rows" + wallTile "column,row" (from the top
+    // left) + wallBezel "x,y" (gap between neighbouring pictures as a fraction
+    // of a display's width / height; the picture runs on behind it).
+    std::string roi;
+    std::string wallGrid;
+    std::string wallTile;
+    std::string wallBezel;
+    // GL outputs (windows / displays) drawn from the one decode. "outputs" is
+    // the count (restart to change it); "output<N>.display", ".crop"
+    // ("x,y,width,height" in cached frame pixels - within the roi, if
+    // set), ".scaleMode", ".warpMesh",
+    // ".warpCorners" and ".blendMask" (N from 1) override the top-level keys.
+    std::vector<OutputWindow::Settings> outputs;
 };
 
+// Top-level keys as defaults for every output
+OutputWindow::Settings outputDefaults(const Settings& settings) {
+    OutputWindow::Settings output;
+    output.scaleMode = settings.scaleMode;
+    output.warpMesh = settings.warpMesh;
+    output.warpCorners = settings.warpCorners;
+    output.blendMask = settings.blendMask;
+    return output;
+}
+
 std::string getConfigFilePath() {
     const std::string configName = "consoleVideoPlayer.config.json";
 
@@ -146,31 +241,119 @@ Settings loadSettings() {
             }
             if (json.count("windowTitle")) settings.windowTitle = json["windowTitle"];
             if (json.count("scaleMode")) settings.scaleMode = json["scaleMode"];
+            if (json.count("renderer")) settings.renderer = json["renderer"];
+            if (json.count("coldCacheMB")) settings.coldCacheMB = std::stoi(json["coldCacheMB"]);
+            if (json.count("frameMemory")) settings.frameMemory = json["frameMemory"];
+            if (json.count("lockFrameMemory")) settings.lockFrameMemory = (json["lockFrameMemory"] == "true");
+            if (json.count("adaptiveMemory")) settings.adaptiveMemory = (json["adaptiveMemory"] == "true");
+            if (json.count("thumbnails")) settings.thumbnails = (json["thumbnails"] == "true");
+            if (json.count("thumbnailCacheMB")) settings.thumbnailCacheMB = std::stoi(json["thumbnailCacheMB"]);
+            if (json.count("thumbnailIntervalSeconds")) settings.thumbnailIntervalSeconds = std::stod(json["thumbnailIntervalSeconds"]);
+            if (json.count("thumbnailCachePath")) settings.thumbnailCachePath = json["thumbnailCachePath"];
+            if (json.count("decodeThreads")) settings.decodeThreads = std::stoi(json["decodeThreads"]);
+            if (json.count("playbackThreading")) settings.playbackThreading = json["playbackThreading"];
+            if (json.count("playbackThreads")) settings.playbackThreads = std::stoi(json["playbackThreads"]);
+            if (json.count("seekThreading")) settings.seekThreading = json["seekThreading"];
+            if (json.count("seekThreads")) settings.seekThreads = std::stoi(json["seekThreads"]);
+            if (json.count("intraFastPath")) settings.intraFastPath = (json["intraFastPath"] == "true");
+            if (json.count("sequenceFrameRate")) settings.sequenceFrameRate = std::stod(json["sequenceFrameRate"]);
+            if (json.count("rawWidth")) settings.rawWidth = std::stoi(json["rawWidth"]);
+            if (json.count("rawHeight")) settings.rawHeight = std::stoi(json["rawHeight"]);
+            if (json.count("rawFormat")) settings.rawFormat = json["rawFormat"];
+            if (json.count("rawFrameRate")) settings.rawFrameRate = std::stod(json["rawFrameRate"]);
+            if (json.count("rawLatestOnly")) settings.rawLatestOnly = (json["rawLatestOnly"] == "true");
+            if (json.count("videoStreams")) settings.videoStreams = json["videoStreams"];
+            if (json.count("highBitDepth")) settings.highBitDepth = (json["highBitDepth"] == "true");
+            if (json.count("deinterlace")) settings.deinterlace = json["deinterlace"];
+            if (json.count("frameBlending")) settings.frameBlending = (json["frameBlending"] == "true");
+            if (json.count("colorLut")) settings.colorLut = json["colorLut"];
+            if (json.count("warpMesh")) settings.warpMesh = json["warpMesh"];
+            if (json.count("warpCorners")) settings.warpCorners = json["warpCorners"];
+            if (json.count("blendMask")) settings.blendMask = json["blendMask"];
+            if (json.count("roi")) settings.roi = json["roi"];
+            if (json.count("wallGrid")) settings.wallGrid = json["wallGrid"];
+            if (json.count("wallTile")) settings.wallTile = json["wallTile"];
+            if (json.count("wallBezel")) settings.wallBezel = json["wallBezel"];
+
+            int outputCount = json.count("outputs") ? std::max(1, std::stoi(json["outputs"])) : 1;
+            for (int i = 1; i <= outputCount; i++) {
+                OutputWindow::Settings output = outputDefaults(settings);
+                std::string prefix = "output" + std::to_string(i) + ".";
+                if (json.count(prefix + "display")) output.display = std::stoi(json[prefix + "display"]);
+                if (json.count(prefix + "crop")) output.crop = json[prefix + "crop"];
+                if (json.count(prefix + "scaleMode")) output.scaleMode = json[prefix + "scaleMode"];
+                if (json.count(prefix + "warpMesh")) output.warpMesh = json[prefix + "warpMesh"];
+                if (json.count(prefix + "warpCorners")) output.warpCorners = json[prefix + "warpCorners"];
+                if (json.count(prefix + "blendMask")) output.blendMask = json[prefix + "blendMask"];
+                settings.outputs.push_back(output);
+            }
 
         }
     } catch (const std::exception& e) {
         std::cout << "Warning: Could not load settings, using defaults: " << e.what() << std::endl;
     }
+    if (settings.outputs.empty()) settings.outputs.push_back(outputDefaults(settings));
     return settings;
 }
 
+// Video stream numbers to play: "all" or a comma-separated list (0 = first video stream)
+std::vector<int> parseVideoStreams(const std::string& spec, const std::string& path) {
+    std::vector<int> streams;
+    if (spec == "all") {
+        int count = VideoPlayer::countVideoStreams(path);
+        for (int i = 0; i < count; i++) streams.push_back(i);
+    } else {
+        std::stringstream list(spec);
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            try {
+                streams.push_back(std::stoi(item));
+            } catch (const std::exception&) {
+                std::cout << "Warning: ignoring video stream '" << item << "'" << std::endl;
+            }
+        }
+    }
+    // Raw input and image sequences have exactly one stream
+    if (RawFrameSource::isRawUri(path) || ImageSequence::isSequence(path)) streams.resize(1, 0);
+    if (streams.empty()) streams.push_back(0);
+    return streams;
+}
+
 // Global video player for UDP callback
 // UDP-based command handling (replaced by JACK Transport)
 // VideoPlayer* g_videoPlayer = nullptr;
 // void handleCommand(const std::string& command) { ... }
 
-int main() {
+int main(int argc, char* argv[]) {
     // Install signal handlers
     signal(SIGSEGV, signal_handler);
     signal(SIGABRT, signal_handler);
 
+    // Offline tools - no window, no JACK
+    if (argc >= 3 && std::string(argv[1]) == "--bench-threading") {
+        return runThreadingBenchmark(argv[2]);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "--bench-software") {
+        int width = 1920;
+        int height = 1080;
+        if (argc >= 3 && sscanf(argv[2], "%dx%d", &width, &height) != 2) {
+            std::cerr << "Usage: consoleVideoPlayer --bench-software [WIDTHxHEIGHT]" << std::endl;
+            return 1;
+        }
+        return runScalerBenchmark(width, height);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "--check-renderer") {
+        return runRendererCheck();
+    }
+
     std::cout << "Console Video Player (JACK Sync)" << std::endl;
     std::cout << "=================================" << std::endl;
 
     auto settings = loadSettings();
 
-    // Check if video file exists
-    if (!std::filesystem::exists(settings.videoFilePath)) {
+    // Check if video file exists (a %04d sequence pattern or raw input is checked when it's opened)
+    if (!std::filesystem::exists(settings.videoFilePath) && !ImageSequence::isSequence(settings.videoFilePath) &&
+        !RawFrameSource::isRawUri(settings.videoFilePath)) {
         std::cerr << "Error: Video file not found at " << settings.videoFilePath << std::endl;
         return 1;
     }
@@ -181,21 +364,22 @@ int main() {
         return 1;
     }
 
-    // Set OpenGL attributes
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+    // Set OpenGL attributes (version and profile per backend below)
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
     // Create window
-    Uint32 windowFlags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN;
+    // HiDPI: full-resolution drawables; layouts use the drawable size, not the window size
+    Uint32 windowFlags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI;
     int windowWidth = 1280;
     int windowHeight = 720;
 
+    // The first output's display; any others open their own windows once GL is up
+    int primaryDisplay = settings.outputs.front().display;
     if (settings.fullscreen) {
         windowFlags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
         // Query actual display size
         SDL_DisplayMode dm;
-        if (SDL_GetDesktopDisplayMode(0, &dm) == 0) {
+        if (SDL_GetDesktopDisplayMode(primaryDisplay, &dm) == 0) {
             windowWidth = dm.w;
             windowHeight = dm.h;
             std::cout << "Fullscreen: " << windowWidth << "x" << windowHeight << std::endl;
@@ -205,76 +389,278 @@ int main() {
         }
     }
 
-    SDL_Window* window = SDL_CreateWindow(
-        settings.windowTitle.c_str(),
-        SDL_WINDOWPOS_CENTERED,
-        SDL_WINDOWPOS_CENTERED,
-        windowWidth, windowHeight,
-        windowFlags
-    );
+    SDL_Window* window = nullptr;
+    SDL_GLContext glContext = nullptr;
+    std::unique_ptr<GlRenderer> renderer;
+
+    // Vulkan and software present on their own; everything GL below is
+    // skipped unless a GL renderer is up
+    bool vulkanActive = false;
+    std::unique_ptr<SoftwareRenderer> softwareRenderer;
+#ifdef HAVE_VULKAN
+    std::unique_ptr<VulkanRenderer> vulkanRenderer;
+    if (settings.renderer == "vulkan") {
+        window = SDL_CreateWindow(
+            settings.windowTitle.c_str(),
+            SDL_WINDOWPOS_CENTERED_DISPLAY(primaryDisplay),
+            SDL_WINDOWPOS_CENTERED_DISPLAY(primaryDisplay),
+            windowWidth, windowHeight,
+            (windowFlags & ~SDL_WINDOW_OPENGL) | SDL_WINDOW_VULKAN
+        );
+        if (window) {
+            vulkanRenderer = std::make_unique<VulkanRenderer>();
+            if (vulkanRenderer->init(window)) {
+                vulkanRenderer->setScaleMode(OutputLayout::parseScaleMode(settings.scaleMode));
+                vulkanActive = true;
+                std::cout << "✓ Vulkan renderer" << std::endl;
+            } else {
+                vulkanRenderer.reset();
+                SDL_DestroyWindow(window);
+                window = nullptr;
+            }
+        }
+        if (!vulkanActive) {
+            std::cout << "⚠ Vulkan unavailable - falling back to OpenGL" << std::endl;
+        }
+    }
+#else
+    if (settings.renderer == "vulkan") {
+        std::cout << "⚠ Built without Vulkan - falling back to OpenGL" << std::endl;
+    }
+#endif
 
-    if (!window) {
-        std::cerr << "Window creation failed: " << SDL_GetError() << std::endl;
-        SDL_Quit();
-        return 1;
+    // Create window and OpenGL context, trying each backend in turn. The window is
+    // recreated per attempt: EGL picks its config (GL or ES) when the window is made.
+    std::vector<GlRenderer::Backend> glBackends;
+    if (!vulkanActive && settings.renderer != "software") {
+        glBackends = GlRenderer::parseBackends(settings.renderer);
     }
+    for (GlRenderer::Backend backend : glBackends) {
+        GlRenderer::setContextAttributes(backend);
+        window = SDL_CreateWindow(
+            settings.windowTitle.c_str(),
+            SDL_WINDOWPOS_CENTERED_DISPLAY(primaryDisplay),
+            SDL_WINDOWPOS_CENTERED_DISPLAY(primaryDisplay),
+            windowWidth, windowHeight,
+            windowFlags
+        );
+        if (!window) {
+            std::cerr << "Window creation failed: " << SDL_GetError() << std::endl;
+            continue;
+        }
 
-    // Create OpenGL context
-    SDL_GLContext glContext = SDL_GL_CreateContext(window);
-    if (!glContext) {
-        std::cerr << "OpenGL context creation failed: " << SDL_GetError() << std::endl;
+        glContext = SDL_GL_CreateContext(window);
+        if (!glContext) {
+            std::cout << "⚠ No " << GlRenderer::backendName(backend) << " context: " << SDL_GetError() << std::endl;
+        } else {
+            renderer = GlRenderer::create(backend);
+            if (renderer->init()) break;
+            std::cout << "⚠ " << GlRenderer::backendName(backend) << " renderer failed to initialise" << std::endl;
+            renderer.reset();
+            SDL_GL_DeleteContext(glContext);
+            glContext = nullptr;
+        }
         SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
+        window = nullptr;
     }
 
-    // Load PBO extension functions manually
-    glGenBuffers = (PFNGLGENBUFFERSPROC)SDL_GL_GetProcAddress("glGenBuffers");
-    glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)SDL_GL_GetProcAddress("glDeleteBuffers");
-    glBindBuffer = (PFNGLBINDBUFFERPROC)SDL_GL_GetProcAddress("glBindBuffer");
-    glBufferData = (PFNGLBUFFERDATAPROC)SDL_GL_GetProcAddress("glBufferData");
+    // No GL at all (or asked for): scale on the CPU into an SDL software renderer
+    bool glActive = renderer != nullptr;
+    if (!glActive && !vulkanActive) {
+        if (settings.renderer != "software") {
+            std::cout << "⚠ OpenGL context creation failed for every renderer backend - using software presentation"
+                      << std::endl;
+        }
+        window = SDL_CreateWindow(
+            settings.windowTitle.c_str(),
+            SDL_WINDOWPOS_CENTERED_DISPLAY(primaryDisplay),
+            SDL_WINDOWPOS_CENTERED_DISPLAY(primaryDisplay),
+            windowWidth, windowHeight,
+            windowFlags & ~SDL_WINDOW_OPENGL
+        );
+        if (window) {
+            softwareRenderer = std::make_unique<SoftwareRenderer>();
+            if (!softwareRenderer->init(window)) {
+                softwareRenderer.reset();
+            }
+        }
+        if (!softwareRenderer) {
+            std::cerr << "No renderer backend could start" << std::endl;
+            if (window) SDL_DestroyWindow(window);
+            SDL_Quit();
+            return 1;
+        }
+        softwareRenderer->setScaleMode(OutputLayout::parseScaleMode(settings.scaleMode));
+    }
+
+    if (glActive) {
+        renderer->setScaleMode(OutputLayout::parseScaleMode(settings.scaleMode));
+
+        // Load PBO extension functions manually
+        glGenBuffers = (PFNGLGENBUFFERSPROC)SDL_GL_GetProcAddress("glGenBuffers");
+        glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)SDL_GL_GetProcAddress("glDeleteBuffers");
+        glBindBuffer = (PFNGLBINDBUFFERPROC)SDL_GL_GetProcAddress("glBindBuffer");
+        glBufferData = (PFNGLBUFFERDATAPROC)SDL_GL_GetProcAddress("glBufferData");
 
-    if (!glGenBuffers || !glDeleteBuffers || !glBindBuffer || !glBufferData) {
-        std::cout << "⚠ PBOs not supported - using synchronous texture uploads" << std::endl;
-        // Continue without PBOs - will use fallback path
+        if (!glGenBuffers || !glDeleteBuffers || !glBindBuffer || !glBufferData) {
+            std::cout << "⚠ PBOs not supported - using synchronous texture uploads" << std::endl;
+            // Continue without PBOs - will use fallback path
+        }
+
+        // Enable vsync
+        SDL_GL_SetSwapInterval(1);
     }
 
-    // Enable vsync
-    SDL_GL_SetSwapInterval(1);
+    // 16-bit plane textures + YUV shader for high-bit-depth sources; without
+    // GLSL (or without GL at all) they are converted to RGB24 like everything else
+    YuvPlaneRenderer yuvRenderer;
+    bool highBitDepth = settings.highBitDepth && glActive && yuvRenderer.init();
+
+    // Field-rate deinterlacing, used only when a stream flags itself interlaced
+    Deinterlacer deinterlacer;
+    Deinterlacer::Mode deinterlaceMode = Deinterlacer::parseMode(settings.deinterlace);
+    if (deinterlaceMode != Deinterlacer::Mode::Off && (!glActive || !deinterlacer.init())) {
+        deinterlaceMode = Deinterlacer::Mode::Off;
+    }
+
+    // Frame-rate mismatch: blend neighbouring frames instead of repeating them
+    FrameBlender frameBlender;
+    bool frameBlending = settings.frameBlending && glActive && frameBlender.init();
+
+    // Colour correction LUT, applied by every shader stage as it draws
+    ColorLut colorLut;
+    bool colorLutAvailable = glActive && colorLut.init();
+    if (!settings.colorLut.empty()) {
+        if (colorLutAvailable) {
+            colorLut.load(settings.colorLut);
+        } else {
+            std::cout << "⚠ colorLut needs a GL renderer with 3D textures - ignored" << std::endl;
+        }
+    }
+
+    // Projector alignment (warp mesh, edge-blend mask) and extra outputs are per
+    // GL output - set up with the outputs below
+    if (!glActive) {
+        const OutputWindow::Settings& first = settings.outputs.front();
+        if (!first.warpMesh.empty() || !first.warpCorners.empty() || !first.blendMask.empty()) {
+            std::cout << "⚠ Warping and blend masks need a GL renderer - ignored" << std::endl;
+        }
+        if (settings.outputs.size() > 1) {
+            std::cout << "⚠ Multiple outputs need a GL renderer - using one" << std::endl;
+        }
+    }
 
-    // Get actual window size
-    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    const std::string configPath = getConfigFilePath();
+    std::error_code configTimeError;
+    auto configWriteTime = std::filesystem::last_write_time(configPath, configTimeError);
 
     // Load video
-    VideoPlayer videoPlayer;
+    // Frame memory backing (huge pages / mlock) - must be in place before the first decode
+    FrameMemory::Mode frameMemoryMode = FrameMemory::parseMode(settings.frameMemory);
+    bool reserveFrameMemory = frameMemoryMode != FrameMemory::Mode::Default || settings.lockFrameMemory;
+    FrameMemory::configure(frameMemoryMode, settings.lockFrameMemory);
+
+    // One player per selected stream, all following the same playhead, so
+    // switching streams is just reading another cache at the same frame
+    std::vector<int> streamNumbers = parseVideoStreams(settings.videoStreams, settings.videoFilePath);
+    DecodePool::configure(settings.decodeThreads, (int)streamNumbers.size());
+    double cacheShare = 1.0 / streamNumbers.size();
+    std::vector<std::unique_ptr<VideoPlayer>> players;
+
+    RegionOfInterest regionOfInterest;
+    if (!settings.wallGrid.empty()) {
+        if (!RegionOfInterest::parsePair(settings.wallGrid, regionOfInterest.wallColumns, regionOfInterest.wallRows) ||
+            (!settings.wallTile.empty() &&
+             !RegionOfInterest::parsePair(settings.wallTile, regionOfInterest.wallColumn, regionOfInterest.wallRow)) ||
+            (!settings.wallBezel.empty() &&
+             !RegionOfInterest::parsePair(settings.wallBezel, regionOfInterest.bezelX, regionOfInterest.bezelY))) {
+            std::cout << "⚠ Bad wallGrid/wallTile/wallBezel - showing whole frames" << std::endl;
+            regionOfInterest = RegionOfInterest();
+        }
+    } else if (!settings.roi.empty() && !RegionOfInterest::parseRect(settings.roi, regionOfInterest.rect)) {
+        std::cout << "⚠ Bad roi \"" << settings.roi << "\" - expected \"x,y,width,height\"" << std::endl;
+    }
 
-    if (!videoPlayer.loadVideo(settings.videoFilePath)) {
-        std::cerr << "Failed to load video: " << videoPlayer.getErrorMessage() << std::endl;
-        SDL_GL_DeleteContext(glContext);
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
+    for (int streamNumber : streamNumbers) {
+        auto player = std::make_unique<VideoPlayer>();
+        player->setColdCacheBudget((size_t)std::max(0, settings.coldCacheMB) * 1024 * 1024);
+        player->setCacheShare(cacheShare);
+        player->setReserveFrameMemory(reserveFrameMemory);
+        player->setHighBitDepth(highBitDepth);
+        player->setVideoStream(streamNumber);
+
+        ThumbnailIndex::Options thumbnailOptions;
+        thumbnailOptions.budgetBytes = (size_t)(std::max(1, settings.thumbnailCacheMB) * 1024 * 1024 * cacheShare);
+        thumbnailOptions.intervalSeconds = settings.thumbnailIntervalSeconds;
+        thumbnailOptions.cachePath = settings.thumbnailCachePath;
+        if (!thumbnailOptions.cachePath.empty() && streamNumbers.size() > 1) {
+            thumbnailOptions.cachePath += "." + std::to_string(streamNumber);
+        }
+        player->setThumbnails(settings.thumbnails, thumbnailOptions);
+        player->setCodecThreading(
+            VideoPlayer::parseCodecThreading(settings.playbackThreading, settings.playbackThreads),
+            VideoPlayer::parseCodecThreading(settings.seekThreading, settings.seekThreads));
+        player->setIntraFastPath(settings.intraFastPath);
+        player->setSequenceFrameRate(settings.sequenceFrameRate);
+        player->setRegionOfInterest(regionOfInterest);
+
+        RawFrameSource::Options rawOptions;
+        rawOptions.width = settings.rawWidth;
+        rawOptions.height = settings.rawHeight;
+        rawOptions.format = settings.rawFormat;
+        rawOptions.latestOnly = settings.rawLatestOnly;
+        player->setRawInput(rawOptions, settings.rawFrameRate);
+
+        if (!player->loadVideo(settings.videoFilePath)) {
+            std::cerr << "Failed to load video: " << player->getErrorMessage() << std::endl;
+            players.clear();
+            SDL_GL_DeleteContext(glContext);
+            SDL_DestroyWindow(window);
+            SDL_Quit();
+            return 1;
+        }
+
+        std::cout << "Video stream " << streamNumber << ": " << player->getWidth() << "x" << player->getHeight()
+                  << " @ " << player->getFPS() << " fps (" << player->getDuration() << "s)" << std::endl;
+        players.push_back(std::move(player));
     }
 
-    std::cout << "Video: " << videoPlayer.getWidth() << "x" << videoPlayer.getHeight()
-              << " @ " << videoPlayer.getFPS() << " fps (" << videoPlayer.getDuration() << "s)" << std::endl;
+    // The stream on screen
+    size_t activeStream = 0;
+    VideoPlayer* videoPlayer = players[activeStream].get();
+
+    // Follow the service's memory limit so the cache shrinks before the OOM killer steps in
+    std::unique_ptr<MemoryPressureMonitor> memoryMonitor;
+    if (settings.adaptiveMemory) {
+        memoryMonitor = std::make_unique<MemoryPressureMonitor>(
+            [&players](double scale, const std::string& reason) {
+                for (auto& player : players) {
+                    player->setCacheBudgetScale(scale, reason);
+                }
+            });
+    }
 
     // Setup OpenGL texture
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLuint texture = 0;
+    if (glActive) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
 
     // Setup PBOs (Pixel Buffer Objects) for async texture uploads (if available)
     GLuint pbos[2] = {0, 0};
-    size_t pboSize = videoPlayer.getWidth() * videoPlayer.getHeight() * 3; // RGB24
+    size_t pboSize = 0;  // RGB24, sized for the largest stream (uploads re-specify it per frame anyway)
+    for (auto& player : players) {
+        pboSize = std::max(pboSize, (size_t)player->getWidth() * player->getHeight() * 3);
+    }
     int pboIndex = 0;      // Current PBO for uploading
     bool pbosEnabled = false;
 
-    if (glGenBuffers && glBindBuffer && glBufferData) {
+    if (glActive && renderer->hasPixelBuffers() && glGenBuffers && glBindBuffer && glBufferData) {
         glGenBuffers(2, pbos);
 
         // Initialize both PBOs
@@ -288,22 +674,44 @@ int main() {
         std::cout << "✓ PBO double-buffering enabled" << std::endl;
     }
 
-    // Setup OpenGL viewport
-    glViewport(0, 0, windowWidth, windowHeight);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(0, windowWidth, windowHeight, 0, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    // Viewport and projection follow the window in renderer->setLayout()
+    if (glActive) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // RGB24 rows aren't 4-byte aligned for every width
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    }
 
-    glEnable(GL_TEXTURE_2D);
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    // GL outputs: the first on the window above, the rest on their own windows
+    // with contexts sharing its textures and programs - one decode and one
+    // upload per frame, however many outputs draw it
+    std::vector<std::unique_ptr<OutputWindow>> outputs;
+    std::vector<OutputWindow::Settings> outputSettings;  // As last applied - crops are redone on a stream switch
+    if (glActive) {
+        outputs.push_back(std::make_unique<OutputWindow>(window, glContext, renderer.get()));
+        for (size_t i = 1; i < settings.outputs.size(); i++) {
+            std::string title = settings.windowTitle + " (" + std::to_string(i + 1) + ")";
+            auto output = OutputWindow::create((int)i + 1, renderer->getBackend(), title, windowFlags,
+                                               settings.outputs[i].display);
+            if (!output) {
+                std::cout << "⚠ Output " << i + 1 << " unavailable - skipped" << std::endl;
+                continue;
+            }
+            outputs.push_back(std::move(output));
+        }
+        for (size_t i = 0; i < outputs.size(); i++) {
+            outputs[i]->configure(settings.outputs[i], videoPlayer->getWidth(), videoPlayer->getHeight());
+        }
+        outputSettings = settings.outputs;
+        if (outputs.size() > 1) {
+            std::cout << "✓ " << outputs.size() << " outputs" << std::endl;
+        }
+    }
 
     // Initialize JACK Transport client
     JackTransportClient jackTransport("consoleVideoPlayer");
     if (!jackTransport.isInitialized()) {
         std::cerr << "Failed to initialize JACK Transport: " << jackTransport.getErrorMessage() << std::endl;
         std::cerr << "Make sure JACK server is running (try: jackd -d alsa -r 48000)" << std::endl;
+        outputs.clear();
         SDL_GL_DeleteContext(glContext);
         SDL_DestroyWindow(window);
         SDL_Quit();
@@ -311,61 +719,107 @@ int main() {
     }
 
     jack_nframes_t jackSampleRate = jackTransport.getSampleRate();
-    double fps = videoPlayer.getFPS();
 
     std::cout << "✓ JACK Transport synced (" << jackSampleRate << " Hz)" << std::endl;
     std::cout << "\nReady. Press ESC or Q to quit.\n" << std::endl;
 
     // Start playing
-    videoPlayer.play();
+    for (auto& player : players) {
+        player->play();
+    }
+
+    // One refresh: the loop waits this long when there's no frame to present,
+    // and the transport position is projected this far ahead to the next vblank
+    SDL_DisplayMode displayMode;
+    int refreshRate = (SDL_GetWindowDisplayMode(window, &displayMode) == 0 && displayMode.refresh_rate > 0)
+                          ? displayMode.refresh_rate : 60;
+    Uint32 idleDelayMs = (Uint32)std::max(1, 1000 / refreshRate);
+    double refreshSeconds = 1.0 / refreshRate;
 
     // Main render loop
     bool running = true;
     SDL_Event event;
 
+    // Periodic stats
+    uint64_t uploadsSkipped = 0;
+    auto lastStatsTime = std::chrono::steady_clock::now();
+    auto lastConfigCheck = lastStatsTime;
+    FrameMemory::PageFaults lastPageFaults = FrameMemory::pageFaults();
+
     while (running) {
         // Handle events
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 running = false;
+            } else if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                for (auto& output : outputs) {
+                    output->handleWindowEvent(event.window);
+                }
+#ifdef HAVE_VULKAN
+                if (vulkanRenderer) vulkanRenderer->resize();
+#endif
             } else if (event.type == SDL_KEYDOWN) {
                 if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_q) {
                     running = false;
                 } else if (event.key.keysym.sym == SDLK_SPACE) {
-                    if (videoPlayer.isPlaying()) {
-                        videoPlayer.pause();
-                    } else {
-                        videoPlayer.play();
+                    bool play = !videoPlayer->isPlaying();
+                    for (auto& player : players) {
+                        if (play) player->play(); else player->pause();
+                    }
+                } else if (event.key.keysym.sym == SDLK_l && colorLut.isLoaded()) {
+                    colorLut.setBypass(!colorLut.isBypassed());
+                } else if (event.key.keysym.sym >= SDLK_1 && event.key.keysym.sym <= SDLK_9) {
+                    // Every stream has the playhead frame decoded - the next frame drawn comes from the new one
+                    size_t stream = (size_t)(event.key.keysym.sym - SDLK_1);
+                    if (stream < players.size() && stream != activeStream) {
+                        activeStream = stream;
+                        videoPlayer = players[activeStream].get();
+                        // Crops are in the stream's own pixels
+                        for (size_t i = 0; i < outputs.size() && i < outputSettings.size(); i++) {
+                            outputs[i]->configure(outputSettings[i], videoPlayer->getWidth(), videoPlayer->getHeight());
+                        }
+                        std::cout << "Switched to video stream " << videoPlayer->getVideoStream() << std::endl;
                     }
                 }
             }
         }
 
-        // Update video player
-        videoPlayer.update();
+        // Update video players
+        for (auto& player : players) {
+            player->update();
+        }
 
         // Sync video play/pause state to JACK Transport
         bool jackIsPlaying = jackTransport.isTransportRolling();
         static int pboWarmupFramesRemaining = 0;  // Force sync upload for 2 frames to flush both PBOs
 
-        if (jackIsPlaying && !videoPlayer.isPlaying()) {
-            videoPlayer.play();
+        if (jackIsPlaying && !videoPlayer->isPlaying()) {
+            for (auto& player : players) {
+                player->play();
+            }
             pboWarmupFramesRemaining = 2;  // Flush both PBO buffers with sync uploads
             // Reset PBO index to ensure clean state after warmup
             if (pbosEnabled) {
                 pboIndex = 0;
             }
-        } else if (!jackIsPlaying && videoPlayer.isPlaying()) {
-            videoPlayer.pause();
+        } else if (!jackIsPlaying && videoPlayer->isPlaying()) {
+            for (auto& player : players) {
+                player->pause();
+            }
         }
 
-        // Query JACK transport position and sync video to it
-        jack_nframes_t currentJackFrame = jackTransport.getCurrentFrame();
-        double currentSeconds = (double)currentJackFrame / jackSampleRate;
+        // Query JACK transport position and sync video to it. The query only
+        // moves once per JACK period - rolling, the position is interpolated
+        // within the period and projected one refresh ahead, to the vblank this
+        // draw is shown at, so frames and fields follow real time.
+        double currentSeconds = jackIsPlaying
+            ? (double)jackTransport.getInterpolatedFrame() / jackSampleRate + refreshSeconds
+            : (double)jackTransport.getCurrentFrame() / jackSampleRate;
+        double fps = videoPlayer->getFPS();  // The active stream's timeline - streams can differ in rate
         int targetVideoFrame = (int)(currentSeconds * fps);
 
         // Clamp to valid frame range
-        int totalFrames = videoPlayer.getFrameCount();
+        int totalFrames = videoPlayer->getFrameCount();
         if (targetVideoFrame >= totalFrames) {
             targetVideoFrame = totalFrames - 1;
         }
@@ -374,14 +828,34 @@ int main() {
         }
 
         // Always seek to JACK transport position (works even when paused)
-        videoPlayer.seek(currentSeconds);
+        for (auto& player : players) {
+            player->seek(currentSeconds);
+        }
 
         // Get current frame
-        const VideoFrame* frame = videoPlayer.getCurrentFrame();
+        std::shared_ptr<const VideoFrame> frame = videoPlayer->getCurrentFrame();
         static int lastUploadedFrameIndex = -1;
+        static uint64_t lastUploadedBufferId = 0;
         static int lastTargetVideoFrame = -1;
+        static int textureWidth = 0;
+        static int textureHeight = 0;
+        static VideoFrame::Format textureFormat = VideoFrame::RGB24;
+
+        // Buffer ids currently held by the texture and each PBO (0 = unknown)
+        static uint64_t textureBufferId = 0;
+        static uint64_t pboBufferIds[2] = {0, 0};
+
+        if (frame && vulkanActive) {
+#ifdef HAVE_VULKAN
+            // Uploads, scaling and pacing all live in the Vulkan renderer
+            vulkanRenderer->present(*frame);
+#endif
+        } else if (frame && softwareRenderer) {
+            softwareRenderer->present(*frame);
+        } else if (frame) {
+            // Uploads go to the first output's context; the others share its textures
+            outputs.front()->makeCurrent();
 
-        if (frame) {
             // Detect seeks: if target frame jumped by more than 5 frames, force PBO warmup
             // This flushes stale PBO buffers and ensures correct frame displays immediately
             if (lastTargetVideoFrame != -1 && std::abs(targetVideoFrame - lastTargetVideoFrame) > 5) {
@@ -393,26 +867,81 @@ int main() {
             }
             lastTargetVideoFrame = targetVideoFrame;
 
+            // Interlaced: the first half of each frame period shows the first field,
+            // the second half the other one (thumbnails are progressive)
+            int field = -1;
+            if (deinterlaceMode != Deinterlacer::Mode::Off &&
+                videoPlayer->getFieldOrder() != VideoPlayer::FieldOrder::Progressive &&
+                frame->height == videoPlayer->getHeight()) {
+                double framePhase = currentSeconds * fps - std::floor(currentSeconds * fps);
+                bool topFirst = videoPlayer->getFieldOrder() == VideoPlayer::FieldOrder::TopFirst;
+                field = (topFirst == (framePhase < 0.5)) ? 0 : 1;
+            }
+            // A stand-in (a neighbouring frame, a thumbnail) has no known neighbours
+            bool frameIsTarget = videoPlayer->peekFrame(targetVideoFrame) == frame;
+            // Motion detection compares against the previous frame, so the current one
+            // must be on the texture now, not a frame late through the PBOs. A stand-in
+            // would be compared against the wrong picture - it is bobbed instead.
+            bool motionAdaptive = field >= 0 && deinterlaceMode == Deinterlacer::Mode::Motion &&
+                                  frame->format == VideoFrame::RGB24 && frameIsTarget;
+            // Blending while rolling, on the real target frame; like motion
+            // detection it needs the current frame on the texture now
+            bool blendFrames = frameBlending && field < 0 && videoPlayer->isPlaying() &&
+                               frame->format == VideoFrame::RGB24 && frameIsTarget;
+
+            // Switching between a thumbnail and a full frame changes the texture size
+            // (and between a high-bit-depth frame and an RGB one, the layout);
+            // the PBOs still hold the old one, so flush them with sync uploads
+            if (frame->width != textureWidth || frame->height != textureHeight || frame->format != textureFormat) {
+                pboWarmupFramesRemaining = 2;
+                if (pbosEnabled) {
+                    pboIndex = 0;
+                }
+            }
+
             // Upload when target frame index changes (not just pointer)
-            // This ensures texture updates even when getCurrentFrame() returns same cached frame during seeks
-            if (targetVideoFrame != lastUploadedFrameIndex) {
+            // This ensures texture updates even when getCurrentFrame() returns same cached frame during seeks.
+            // Also upload when the buffer changes at the same index - the real frame replacing
+            // a stand-in (neighbour or thumbnail) once the decoder catches up.
+            if (targetVideoFrame != lastUploadedFrameIndex || frame->bufferId != lastUploadedBufferId) {
                 lastUploadedFrameIndex = targetVideoFrame;
+                lastUploadedBufferId = frame->bufferId;
+                textureWidth = frame->width;
+                textureHeight = frame->height;
+                textureFormat = frame->format;
+
+                bool usePboPath = pbosEnabled && videoPlayer->isPlaying() && pboWarmupFramesRemaining == 0 &&
+                                  !motionAdaptive && !blendFrames;
+
+                // Identical content (deduplicated buffer) already on the texture - skip the upload.
+                // On the PBO path both buffers must hold it too, or the delayed copy would show stale data.
+                bool alreadyOnTexture = textureBufferId == frame->bufferId &&
+                    (!usePboPath || (pboBufferIds[0] == frame->bufferId && pboBufferIds[1] == frame->bufferId));
 
+                if (alreadyOnTexture) {
+                    uploadsSkipped++;
+                }
                 // Use PBOs only when playing (1-frame delay is acceptable during motion)
                 // When paused or warming up PBOs, use synchronous upload for immediate visual feedback
-                if (pbosEnabled && videoPlayer.isPlaying() && pboWarmupFramesRemaining == 0) {
+                else if (usePboPath) {
                     // PBO double-buffering path: async upload (1-frame delay)
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[pboIndex]);
-                    glBufferData(GL_PIXEL_UNPACK_BUFFER, pboSize, frame->data.data(), GL_STREAM_DRAW);
+                    glBufferData(GL_PIXEL_UNPACK_BUFFER, frame->byteSize(), frame->pixels(), GL_STREAM_DRAW);
 
                     glBindTexture(GL_TEXTURE_2D, texture);
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[(pboIndex + 1) % 2]);
 
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
-                                frame->width, frame->height, 0,
-                                GL_RGB, GL_UNSIGNED_BYTE, nullptr); // nullptr = use bound PBO
+                    if (frame->format == VideoFrame::YUV16) {
+                        yuvRenderer.upload(*frame, nullptr);  // Planes at their offsets in the PBO
+                    } else {
+                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
+                                    frame->width, frame->height, 0,
+                                    GL_RGB, GL_UNSIGNED_BYTE, nullptr); // nullptr = use bound PBO
+                    }
 
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    pboBufferIds[pboIndex] = frame->bufferId;
+                    textureBufferId = pboBufferIds[(pboIndex + 1) % 2];
                     pboIndex = (pboIndex + 1) % 2;
                 } else {
                     // Paused, warming up, or PBOs unavailable: synchronous upload (immediate, no delay)
@@ -421,16 +950,22 @@ int main() {
                     if (pbosEnabled && pboWarmupFramesRemaining > 0) {
                         for (int i = 0; i < 2; i++) {
                             glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[i]);
-                            glBufferData(GL_PIXEL_UNPACK_BUFFER, pboSize, frame->data.data(), GL_STREAM_DRAW);
+                            glBufferData(GL_PIXEL_UNPACK_BUFFER, frame->byteSize(), frame->pixels(), GL_STREAM_DRAW);
+                            pboBufferIds[i] = frame->bufferId;
                         }
                     }
 
                     // Then upload texture synchronously (unbind PBO for immediate upload)
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-                    glBindTexture(GL_TEXTURE_2D, texture);
-                    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
-                                frame->width, frame->height, 0,
-                                GL_RGB, GL_UNSIGNED_BYTE, frame->data.data());
+                    if (frame->format == VideoFrame::YUV16) {
+                        yuvRenderer.upload(*frame, frame->pixels());
+                    } else {
+                        glBindTexture(GL_TEXTURE_2D, texture);
+                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
+                                    frame->width, frame->height, 0,
+                                    GL_RGB, GL_UNSIGNED_BYTE, frame->pixels());
+                    }
+                    textureBufferId = frame->bufferId;
 
                     if (pboWarmupFramesRemaining > 0) {
                         pboWarmupFramesRemaining--;  // Count down warmup frames
@@ -438,70 +973,171 @@ int main() {
                 }
             }
 
-            // Clear and render
-            glClear(GL_COLOR_BUFFER_BIT);
-
-            // Calculate rendering dimensions based on scale mode
-            float videoAspect = (float)frame->width / (float)frame->height;
-            float windowAspect = (float)windowWidth / (float)windowHeight;
-
-            float renderWidth, renderHeight;
-            float offsetX = 0, offsetY = 0;
-
-            if (settings.scaleMode == "stretch") {
-                // Stretch to fill - ignore aspect ratio
-                renderWidth = windowWidth;
-                renderHeight = windowHeight;
+            if (motionAdaptive) {
+                std::shared_ptr<const VideoFrame> previous = videoPlayer->peekFrame(targetVideoFrame - 1);
+                deinterlacer.setPrevious(previous.get());
             }
-            else if (settings.scaleMode == "crop") {
-                // Fill window, preserve aspect, crop edges (fit smallest dimension)
-                if (windowAspect > videoAspect) {
-                    // Window wider - fit width, crop top/bottom
-                    renderWidth = windowWidth;
-                    renderHeight = windowWidth / videoAspect;
-                    offsetY = (windowHeight - renderHeight) / 2.0f;
-                } else {
-                    // Window taller - fit height, crop sides
-                    renderHeight = windowHeight;
-                    renderWidth = windowHeight * videoAspect;
-                    offsetX = (windowWidth - renderWidth) / 2.0f;
-                }
+            float blendPhase = 0.0f;
+            if (blendFrames) {
+                std::shared_ptr<const VideoFrame> next = videoPlayer->peekFrame(targetVideoFrame + 1);
+                frameBlender.setNext(next.get());
+                // The target frame and the phase come from the same (vblank) time
+                blendPhase = (float)(currentSeconds * fps - std::floor(currentSeconds * fps));
             }
-            else {
-                // Default: "letterbox" - fit inside, preserve aspect (fit largest dimension)
-                if (windowAspect > videoAspect) {
-                    // Window wider than video - letterbox sides
-                    renderHeight = windowHeight;
-                    renderWidth = windowHeight * videoAspect;
-                    offsetX = (windowWidth - renderWidth) / 2.0f;
+
+            // Other contexts only see the uploads once they're flushed
+            if (outputs.size() > 1) glFlush();
+
+            // Clear and render, once per output
+            for (auto& output : outputs) {
+                GlRenderer& outputRenderer = output->begin(frame->width, frame->height);
+                outputRenderer.clear();
+
+                if (frame->format == VideoFrame::YUV16) {
+                    yuvRenderer.draw(*frame, outputRenderer, field);
+                } else if (field >= 0) {
+                    deinterlacer.draw(texture, *frame, field,
+                                      motionAdaptive ? Deinterlacer::Mode::Motion : Deinterlacer::Mode::Bob,
+                                      outputRenderer);
+                } else if (blendFrames) {
+                    frameBlender.draw(texture, *frame, blendPhase, outputRenderer);
                 } else {
-                    // Window taller than video - letterbox top/bottom
-                    renderWidth = windowWidth;
-                    renderHeight = windowWidth / videoAspect;
-                    offsetY = (windowHeight - renderHeight) / 2.0f;
+                    outputRenderer.drawTexture(texture);
                 }
             }
+        } else if (vulkanActive || softwareRenderer) {
+            // No frame yet (start-up, a seek outside the cache). These paths only
+            // wait for the display inside present(), so sleep a refresh instead of spinning.
+            SDL_Delay(idleDelayMs);
+        }
+
+        // Swap buffers - the first output last, as only its swap waits for vblank
+        for (auto it = outputs.rbegin(); it != outputs.rend(); ++it) {
+            (*it)->swap();
+        }
 
-            // Draw textured quad
-            glBegin(GL_QUADS);
-            glTexCoord2f(0, 0); glVertex2f(offsetX, offsetY);
-            glTexCoord2f(1, 0); glVertex2f(offsetX + renderWidth, offsetY);
-            glTexCoord2f(1, 1); glVertex2f(offsetX + renderWidth, offsetY + renderHeight);
-            glTexCoord2f(0, 1); glVertex2f(offsetX, offsetY + renderHeight);
-            glEnd();
+        auto now = std::chrono::steady_clock::now();
+
+        // Output hot swap: new "colorLut", per-output crop/scale/warp/blend
+        // keys in the config, or the files they name rewritten
+        if (glActive && now - lastConfigCheck >= std::chrono::seconds(1)) {
+            lastConfigCheck = now;
+            auto writeTime = std::filesystem::last_write_time(configPath, configTimeError);
+            if (!configTimeError && writeTime != configWriteTime) {
+                configWriteTime = writeTime;
+                Settings reloaded = loadSettings();
+                if (colorLutAvailable) {
+                    if (reloaded.colorLut.empty()) {
+                        colorLut.unload();
+                    } else if (reloaded.colorLut != colorLut.getPath()) {
+                        colorLut.load(reloaded.colorLut);
+                    }
+                }
+                for (size_t i = 0; i < outputs.size() && i < reloaded.outputs.size(); i++) {
+                    outputs[i]->configure(reloaded.outputs[i], videoPlayer->getWidth(), videoPlayer->getHeight());
+                }
+                outputSettings = reloaded.outputs;
+            }
+            colorLut.reloadIfChanged();
+            for (auto& output : outputs) {
+                output->reloadIfChanged();
+            }
         }
 
-        // Swap buffers
-        SDL_GL_SwapWindow(window);
+        if (now - lastStatsTime >= std::chrono::seconds(STATS_INTERVAL_SECONDS)) {
+            lastStatsTime = now;
+            auto stats = videoPlayer->getCacheStats();
+            std::cout << "[Stats] stream " << videoPlayer->getVideoStream() << " (" << players.size() << " decoding)"
+                      << " | cache: " << stats.hotFrames << "/" << stats.hotLimit << " hot, "
+                      << stats.coldFrames << " cold (" << stats.coldBytes / (1024 * 1024) << " MB)"
+                      << " | dedup: " << stats.dedupFrames << " frames, "
+                      << stats.dedupBytesSaved / (1024 * 1024) << " MB saved"
+                      << " | uploads skipped: " << uploadsSkipped << std::endl;
+
+            auto decode = videoPlayer->getDecodeStats();
+            std::cout << "[Stats] decode: " << decode.avgFrameMs << " ms/frame avg, "
+                      << decode.peakFrameMs << " ms peak, GOP " << decode.gopFrames
+                      << ", load " << (int)(decode.load * 100) << "%, ahead "
+                      << decode.aheadSeconds << "s (" << decode.aheadFrames << " frames)"
+                      << ", " << (decode.seekRole ? "seek" : "playback") << " context ("
+                      << decode.roleSwitches << " switches)"
+                      << (decode.underProvisioned ? " UNDER-PROVISIONED" : "") << std::endl;
+
+            auto catchUp = videoPlayer->getCatchUpStats();
+            std::cout << "[Stats] catch-up: level " << catchUp.level << ", entered L1-L4 "
+                      << catchUp.escalations[1] << "/" << catchUp.escalations[2] << "/"
+                      << catchUp.escalations[3] << "/" << catchUp.escalations[4]
+                      << ", skipped behind " << catchUp.framesSkippedBehind
+                      << ", stale served " << catchUp.staleFramesServed
+                      << ", thumbnails served " << catchUp.thumbnailsServed
+                      << ", missing " << catchUp.missingFrames << std::endl;
+
+            auto requests = videoPlayer->getRequestStats();
+            std::cout << "[Stats] requests: " << requests.submitted << " submitted, "
+                      << requests.fromCache << " from cache, " << requests.met << " met, "
+                      << requests.missed << " missed (worst " << requests.worstLateMs << " ms late), "
+                      << requests.cancelled << " cancelled, " << requests.failed << " failed, "
+                      << requests.pending << " pending" << std::endl;
+
+            if (videoPlayer->isRawInput()) {
+                auto raw = videoPlayer->getRawInputStats();
+                std::cout << "[Stats] raw input: " << raw.framesReceived << " frames, "
+                          << raw.framesZeroCopy << " zero-copy, " << raw.framesSkipped << " skipped" << std::endl;
+            }
+
+            auto pool = DecodePool::instance().getStats();
+            std::cout << "[Stats] decode pool: " << DecodePool::instance().getThreadCount() << " workers, "
+                      << pool.jobsRun << " jobs, " << pool.jobsLate << " started late, "
+                      << pool.steals << " stolen, " << pool.queued << " queued" << std::endl;
+
+            // Any major fault during playback means frame (or code) pages were not resident
+            FrameMemory::PageFaults faults = FrameMemory::pageFaults();
+            std::cout << "[Stats] page faults: " << faults.minor - lastPageFaults.minor << " minor, "
+                      << faults.major - lastPageFaults.major << " major" << std::endl;
+            lastPageFaults = faults;
+
+            if (softwareRenderer) {
+                auto software = softwareRenderer->getStats();
+                std::cout << "[Stats] software: " << software.framesPresented << " presented, "
+                          << software.framesScaled << " scaled (" << software.avgScaleMs << " ms avg, "
+                          << software.maxScaleMs << " ms max)" << std::endl;
+            }
+
+#ifdef HAVE_VULKAN
+            if (vulkanRenderer) {
+                auto present = vulkanRenderer->getStats();
+                std::cout << "[Stats] vulkan: " << present.framesPresented << " presented, "
+                          << present.uploads << " uploads (" << present.uploadsSkipped << " skipped) on "
+                          << (present.dedicatedTransferQueue ? "transfer" : "graphics") << " queue";
+                if (present.presentWait) {
+                    std::cout << ", present latency " << present.lastPresentLatencyMs << " ms (max "
+                              << present.maxPresentLatencyMs << " ms)";
+                }
+                std::cout << std::endl;
+            }
+#endif
+        }
     }
 
     // Cleanup
     // JACK transport client will be automatically cleaned up via RAII
+    if (!outputs.empty()) {
+        outputs.front()->makeCurrent();
+        outputs.clear();
+    }
     if (pbosEnabled && glDeleteBuffers) {
         glDeleteBuffers(2, pbos);
     }
-    glDeleteTextures(1, &texture);
-    SDL_GL_DeleteContext(glContext);
+    if (texture) {
+        glDeleteTextures(1, &texture);
+    }
+    renderer.reset();
+#ifdef HAVE_VULKAN
+    vulkanRenderer.reset();  // Before the window its surface belongs to
+#endif
+    if (glContext) {
+        SDL_GL_DeleteContext(glContext);
+    }
     SDL_DestroyWindow(window);
     SDL_Quit();
     return 0;